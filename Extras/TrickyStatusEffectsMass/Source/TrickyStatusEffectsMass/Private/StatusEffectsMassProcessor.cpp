@@ -0,0 +1,111 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsMassProcessor.h"
+
+#include "MassExecutionContext.h"
+#include "PeriodicStatusEffect.h"
+#include "StatusEffectsMassSubsystem.h"
+#include "StatusEffectsMassTypes.h"
+#include "StatusEffectsStats.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Mass"), STAT_StatusEffects_Mass, STATGROUP_StatusEffects);
+
+namespace StatusEffectsMassProcessor
+{
+	static void AddAttributeDelta(FStatusEffectsMassFragment& Fragment, const FGameplayTag& Attribute, const float Delta)
+	{
+		for (FStatusEffectsMassAttributeDelta& AttributeDelta : Fragment.AttributeDeltas)
+		{
+			if (AttributeDelta.Attribute == Attribute)
+			{
+				AttributeDelta.Delta += Delta;
+				return;
+			}
+		}
+
+		Fragment.AttributeDeltas.Add({Attribute, Delta});
+	}
+
+	static void ProcessFragment(const UStatusEffectsMassSubsystem& Subsystem,
+	                            FStatusEffectsMassFragment& Fragment,
+	                            const float DeltaTime)
+	{
+		Fragment.AttributeDeltas.Reset();
+
+		// Iterating backwards lets expired status effects be swapped out in place
+		for (int32 Index = Fragment.Effects.Num() - 1; Index >= 0; --Index)
+		{
+			FStatusEffectsMassEntry& Entry = Fragment.Effects[Index];
+			const FStatusEffectsMassDefinition* Definition = Subsystem.FindDefinition(Entry.ClassId);
+
+			if (!Definition)
+			{
+				Fragment.Effects.RemoveAtSwap(Index);
+				continue;
+			}
+
+			if (Entry.TimeToNextPeriod >= 0.f)
+			{
+				Entry.TimeToNextPeriod -= DeltaTime;
+
+				while (Entry.TimeToNextPeriod <= 0.f)
+				{
+					Entry.TimeToNextPeriod += Definition->Period;
+					AddAttributeDelta(Fragment,
+					                  Definition->Attribute,
+					                  Definition->PeriodicDefaults->CalculateMagnitudeForStacks(Entry.Stacks));
+				}
+			}
+
+			if (Entry.RemainingTime < 0.f)
+			{
+				continue;
+			}
+
+			Entry.RemainingTime -= DeltaTime;
+
+			if (Entry.RemainingTime <= 0.f)
+			{
+				Fragment.Effects.RemoveAtSwap(Index);
+			}
+		}
+	}
+}
+
+UStatusEffectsMassProcessor::UStatusEffectsMassProcessor()
+{
+	bAutoRegisterWithProcessingPhases = true;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ExecutionOrder.ExecuteInGroup = StatusEffectsMass::ProcessorGroupNames::StatusEffects;
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UStatusEffectsMassProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FStatusEffectsMassFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void UStatusEffectsMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UWorld* World = EntityManager.GetWorld();
+	const UStatusEffectsMassSubsystem* Subsystem = World ? World->GetSubsystem<UStatusEffectsMassSubsystem>() : nullptr;
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Mass);
+
+	EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [Subsystem](FMassExecutionContext& ChunkContext)
+	{
+		const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+
+		for (FStatusEffectsMassFragment& Fragment : ChunkContext.GetMutableFragmentView<FStatusEffectsMassFragment>())
+		{
+			StatusEffectsMassProcessor::ProcessFragment(*Subsystem, Fragment, DeltaTime);
+		}
+	});
+}
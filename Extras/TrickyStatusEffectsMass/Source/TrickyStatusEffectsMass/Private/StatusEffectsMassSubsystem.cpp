@@ -0,0 +1,369 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsMassSubsystem.h"
+
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "PeriodicStatusEffect.h"
+#include "StatusEffectsMassTypes.h"
+#include "StatusEffectsRegistry.h"
+#include "Engine/World.h"
+
+void UStatusEffectsMassSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Definitions are only appended afterward for classes added in the editor
+	if (const UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get())
+	{
+		Definitions.SetNum(Registry->GetNumClasses() + 1);
+	}
+}
+
+void UStatusEffectsMassSubsystem::Deinitialize()
+{
+	Definitions.Empty();
+	DefinitionClasses.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UStatusEffectsMassSubsystem::ApplyStatusEffect(const FStatusEffectsMassEntity& Entity,
+                                                    const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	const FStatusEffectsMassDefinition* Definition = GetOrAddDefinition(StatusEffect);
+
+	if (!Definition)
+	{
+		return false;
+	}
+
+	FMassEntityManager* EntityManager = GetEntityManager();
+
+	if (!EntityManager || !EntityManager->IsEntityValid(Entity.Handle))
+	{
+		return false;
+	}
+
+	FStatusEffectsMassFragment* Fragment = EntityManager->GetFragmentDataPtr<FStatusEffectsMassFragment>(Entity.Handle);
+
+	if (!Fragment)
+	{
+		EntityManager->AddFragmentToEntity(Entity.Handle, FStatusEffectsMassFragment::StaticStruct());
+		Fragment = EntityManager->GetFragmentDataPtr<FStatusEffectsMassFragment>(Entity.Handle);
+	}
+
+	if (!Fragment)
+	{
+		return false;
+	}
+
+	const uint16 ClassId = GetClassId(StatusEffect);
+
+	for (FStatusEffectsMassEntry& Entry : Fragment->Effects)
+	{
+		if (Entry.ClassId == ClassId)
+		{
+			RefreshEntry(*Definition, Entry);
+			return true;
+		}
+	}
+
+	const UStatusEffectBase* Defaults = Definition->Defaults;
+	FStatusEffectsMassEntry& Entry = Fragment->Effects.AddDefaulted_GetRef();
+	Entry.ClassId = ClassId;
+	Entry.Stacks = Defaults->GetIsStackable() ? static_cast<uint16>(Defaults->GetInitialStacks()) : 1;
+	Entry.RemainingTime = Defaults->GetIsInfinite() ? -1.f : Defaults->GetDuration();
+
+	if (Definition->PeriodicDefaults)
+	{
+		Entry.TimeToNextPeriod = Definition->PeriodicDefaults->GetApplyOnActivation() ? 0.f : Definition->Period;
+	}
+
+	return true;
+}
+
+bool UStatusEffectsMassSubsystem::RefreshStatusEffect(const FStatusEffectsMassEntity& Entity,
+                                                      const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+	const uint16 ClassId = GetClassId(StatusEffect);
+	const FStatusEffectsMassDefinition* Definition = FindDefinition(ClassId);
+
+	if (!Fragment || !Definition)
+	{
+		return false;
+	}
+
+	for (FStatusEffectsMassEntry& Entry : Fragment->Effects)
+	{
+		if (Entry.ClassId == ClassId)
+		{
+			RefreshEntry(*Definition, Entry);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UStatusEffectsMassSubsystem::RemoveStatusEffect(const FStatusEffectsMassEntity& Entity,
+                                                     const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+
+	if (!Fragment)
+	{
+		return false;
+	}
+
+	const uint16 ClassId = GetClassId(StatusEffect);
+
+	auto Predicate = [ClassId](const FStatusEffectsMassEntry& Entry)
+	{
+		return Entry.ClassId == ClassId;
+	};
+
+	return Fragment->Effects.RemoveAllSwap(Predicate) > 0;
+}
+
+void UStatusEffectsMassSubsystem::RemoveAllStatusEffects(const FStatusEffectsMassEntity& Entity)
+{
+	if (FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle))
+	{
+		Fragment->Effects.Reset();
+	}
+}
+
+FStatusEffectsMassEntity UStatusEffectsMassSubsystem::MakeStatusEffectsMassEntity(const int32 Index,
+                                                                                const int32 SerialNumber)
+{
+	return FMassEntityHandle(Index, SerialNumber);
+}
+
+void UStatusEffectsMassSubsystem::BreakStatusEffectsMassEntity(const FStatusEffectsMassEntity& Entity,
+                                                               int32& Index,
+                                                               int32& SerialNumber)
+{
+	Index = Entity.Handle.Index;
+	SerialNumber = Entity.Handle.SerialNumber;
+}
+
+bool UStatusEffectsMassSubsystem::IsEntityValid(const FStatusEffectsMassEntity& Entity) const
+{
+	const FMassEntityManager* EntityManager = GetEntityManager();
+	return EntityManager && EntityManager->IsEntityValid(Entity.Handle);
+}
+
+bool UStatusEffectsMassSubsystem::HasStatusEffect(const FStatusEffectsMassEntity& Entity,
+                                                  const TSubclassOf<UStatusEffectBase> StatusEffect) const
+{
+	return GetStatusEffectStacks(Entity, StatusEffect) > 0;
+}
+
+bool UStatusEffectsMassSubsystem::HasAnyStatusEffect(const FStatusEffectsMassEntity& Entity) const
+{
+	const FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+	return Fragment && !Fragment->Effects.IsEmpty();
+}
+
+bool UStatusEffectsMassSubsystem::HasAnyStatusEffectOfType(const FStatusEffectsMassEntity& Entity,
+                                                           const EStatusEffectType StatusEffectType) const
+{
+	const FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+
+	if (!Fragment)
+	{
+		return false;
+	}
+
+	auto Predicate = [this, StatusEffectType](const FStatusEffectsMassEntry& Entry)
+	{
+		const FStatusEffectsMassDefinition* Definition = FindDefinition(Entry.ClassId);
+		return Definition && Definition->Defaults->GetEffectType() == StatusEffectType;
+	};
+
+	return Fragment->Effects.ContainsByPredicate(Predicate);
+}
+
+int32 UStatusEffectsMassSubsystem::GetStatusEffectStacks(const FStatusEffectsMassEntity& Entity,
+                                                         const TSubclassOf<UStatusEffectBase> StatusEffect) const
+{
+	const FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+
+	if (!Fragment)
+	{
+		return 0;
+	}
+
+	const uint16 ClassId = GetClassId(StatusEffect);
+
+	for (const FStatusEffectsMassEntry& Entry : Fragment->Effects)
+	{
+		if (Entry.ClassId == ClassId)
+		{
+			return Entry.Stacks;
+		}
+	}
+
+	return 0;
+}
+
+float UStatusEffectsMassSubsystem::GetStatusEffectRemainingTime(
+	const FStatusEffectsMassEntity& Entity,
+	const TSubclassOf<UStatusEffectBase> StatusEffect) const
+{
+	const FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+
+	if (!Fragment)
+	{
+		return -1.f;
+	}
+
+	const uint16 ClassId = GetClassId(StatusEffect);
+
+	for (const FStatusEffectsMassEntry& Entry : Fragment->Effects)
+	{
+		if (Entry.ClassId == ClassId)
+		{
+			return Entry.RemainingTime;
+		}
+	}
+
+	return -1.f;
+}
+
+void UStatusEffectsMassSubsystem::GetAllStatusEffects(const FStatusEffectsMassEntity& Entity,
+                                                      TArray<TSubclassOf<UStatusEffectBase>>& OutStatusEffects) const
+{
+	const FStatusEffectsMassFragment* Fragment = GetFragment(Entity.Handle);
+
+	if (!Fragment)
+	{
+		return;
+	}
+
+	for (const FStatusEffectsMassEntry& Entry : Fragment->Effects)
+	{
+		if (const FStatusEffectsMassDefinition* Definition = FindDefinition(Entry.ClassId))
+		{
+			OutStatusEffects.Add(Definition->Defaults->GetClass());
+		}
+	}
+}
+
+const FStatusEffectsMassDefinition* UStatusEffectsMassSubsystem::FindDefinition(const uint16 ClassId) const
+{
+	if (!Definitions.IsValidIndex(ClassId) || !Definitions[ClassId].Defaults)
+	{
+		return nullptr;
+	}
+
+	return &Definitions[ClassId];
+}
+
+bool UStatusEffectsMassSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+const FStatusEffectsMassDefinition* UStatusEffectsMassSubsystem::GetOrAddDefinition(
+	const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	const uint16 ClassId = GetClassId(StatusEffect);
+
+	if (ClassId == UStatusEffectsRegistry::InvalidClassId)
+	{
+		return nullptr;
+	}
+
+	if (const FStatusEffectsMassDefinition* Definition = FindDefinition(ClassId))
+	{
+		return Definition;
+	}
+
+	if (!Definitions.IsValidIndex(ClassId))
+	{
+		Definitions.SetNum(ClassId + 1);
+	}
+
+	FStatusEffectsMassDefinition& Definition = Definitions[ClassId];
+	Definition.Defaults = StatusEffect->GetDefaultObject<UStatusEffectBase>();
+	Definition.PeriodicDefaults = Cast<UPeriodicStatusEffect>(Definition.Defaults);
+
+	if (Definition.PeriodicDefaults)
+	{
+		Definition.Attribute = Definition.PeriodicDefaults->GetAttribute();
+		Definition.Period = FMath::Max(Definition.PeriodicDefaults->GetPeriod(), UE_KINDA_SMALL_NUMBER);
+	}
+
+	DefinitionClasses.Add(StatusEffect);
+	return &Definition;
+}
+
+FMassEntityManager* UStatusEffectsMassSubsystem::GetEntityManager() const
+{
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
+
+FStatusEffectsMassFragment* UStatusEffectsMassSubsystem::GetFragment(const FMassEntityHandle Entity) const
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+
+	if (!EntityManager || !EntityManager->IsEntityValid(Entity))
+	{
+		return nullptr;
+	}
+
+	return EntityManager->GetFragmentDataPtr<FStatusEffectsMassFragment>(Entity);
+}
+
+uint16 UStatusEffectsMassSubsystem::GetClassId(const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+	return IsValid(Registry) ? Registry->GetClassId(StatusEffect) : UStatusEffectsRegistry::InvalidClassId;
+}
+
+void UStatusEffectsMassSubsystem::RefreshEntry(const FStatusEffectsMassDefinition& Definition,
+                                               FStatusEffectsMassEntry& Entry)
+{
+	const UStatusEffectBase* Defaults = Definition.Defaults;
+
+	if (!Defaults->GetIsInfinite())
+	{
+		switch (Defaults->GetTimerBehavior())
+		{
+		case EStatusEffectTimerRefreshBehavior::Ignore:
+			break;
+
+		case EStatusEffectTimerRefreshBehavior::Reset:
+			Entry.RemainingTime = Defaults->GetDuration();
+			break;
+
+		case EStatusEffectTimerRefreshBehavior::Extend:
+			Entry.RemainingTime = FMath::Min(Entry.RemainingTime + Defaults->GetDeltaDuration(),
+			                                 Defaults->GetMaxDuration());
+			break;
+		}
+	}
+
+	if (Defaults->GetIsStackable())
+	{
+		switch (Defaults->GetStacksBehavior())
+		{
+		case EStatusEffectStacksRefreshBehavior::Ignore:
+			break;
+
+		case EStatusEffectStacksRefreshBehavior::Reset:
+			Entry.Stacks = static_cast<uint16>(Defaults->GetInitialStacks());
+			break;
+
+		case EStatusEffectStacksRefreshBehavior::Increase:
+			Entry.Stacks = static_cast<uint16>(FMath::Min(Entry.Stacks + Defaults->GetDeltaStacks(),
+			                                              Defaults->GetMaxStacks()));
+			break;
+		}
+	}
+}
@@ -0,0 +1,6 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyStatusEffectsMass.h"
+
+IMPLEMENT_MODULE(FTrickyStatusEffectsMassModule, TrickyStatusEffectsMass)
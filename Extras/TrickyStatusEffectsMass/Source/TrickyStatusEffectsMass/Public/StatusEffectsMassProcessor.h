@@ -0,0 +1,31 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityQuery.h"
+#include "MassProcessor.h"
+#include "StatusEffectsMassProcessor.generated.h"
+
+/**
+ * Advances durations and periodic attribute changes of status effects applied to Mass entities.
+ * Chunks are processed in parallel. Each entity only touches its own fragment, so expired status effects
+ * are removed in place without deferred commands.
+ * Runs in the StatusEffectsMass::ProcessorGroupNames::StatusEffects group.
+ */
+UCLASS()
+class TRICKYSTATUSEFFECTSMASS_API UStatusEffectsMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectsMassProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,173 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StatusEffectBase.h"
+#include "StatusEffectsMassTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "StatusEffectsMassSubsystem.generated.h"
+
+class UPeriodicStatusEffect;
+struct FMassEntityManager;
+
+/**
+ * Traits of a status effect class read by Mass processors. Built from the default object of the class,
+ * so Mass entities and actors share status effect definitions.
+ */
+struct FStatusEffectsMassDefinition
+{
+	const UStatusEffectBase* Defaults = nullptr;
+
+	/**
+	 * The default object of a periodic status effect class. nullptr for other classes
+	 */
+	const UPeriodicStatusEffect* PeriodicDefaults = nullptr;
+
+	FGameplayTag Attribute;
+
+	float Period = 0.f;
+};
+
+/**
+ * Applies status effects to Mass entities, which can't carry a UStatusEffectsManagerComponent.
+ * States of status effects are stored in FStatusEffectsMassFragment and advanced by UStatusEffectsMassProcessor.
+ * Status effects of entities behave as PerTarget status effects: their durations, stacks, refresh behaviors
+ * and periodic attribute changes come from the status effect classes, while their events aren't called.
+ *
+ * Functions must be called on the game thread outside of Mass processing.
+ * Entities are passed as FStatusEffectsMassEntity, which C++ callers construct implicitly from FMassEntityHandle
+ * and Blueprints make from the index and serial number of the entity.
+ */
+UCLASS()
+class TRICKYSTATUSEFFECTSMASS_API UStatusEffectsMassSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Applies a status effect to an entity. Refreshes the status effect if it's already applied
+	 *
+	 * @param Entity The entity to apply the status effect to
+	 * @param StatusEffect The class of the status effect to apply
+	 * @return true if the status effect was applied or refreshed
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	bool ApplyStatusEffect(const FStatusEffectsMassEntity& Entity, TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	/**
+	 * Refreshes an applied status effect of an entity
+	 *
+	 * @return true if the status effect was refreshed
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	bool RefreshStatusEffect(const FStatusEffectsMassEntity& Entity, TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	/**
+	 * Removes a status effect from an entity
+	 *
+	 * @return true if the status effect was removed
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	bool RemoveStatusEffect(const FStatusEffectsMassEntity& Entity, TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	/**
+	 * Removes all status effects from an entity
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	void RemoveAllStatusEffects(const FStatusEffectsMassEntity& Entity);
+
+	/**
+	 * Makes an entity handle for Blueprints
+	 *
+	 * @param Index The index of the entity
+	 * @param SerialNumber The serial number of the entity
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects", meta=(NativeMakeFunc))
+	static FStatusEffectsMassEntity MakeStatusEffectsMassEntity(const int32 Index, const int32 SerialNumber);
+
+	/**
+	 * Breaks an entity handle into the index and serial number of the entity
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects", meta=(NativeBreakFunc))
+	static void BreakStatusEffectsMassEntity(const FStatusEffectsMassEntity& Entity,
+	                                         int32& Index,
+	                                         int32& SerialNumber);
+
+	/**
+	 * Checks if an entity exists in the world of the subsystem
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool IsEntityValid(const FStatusEffectsMassEntity& Entity) const;
+
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool HasStatusEffect(const FStatusEffectsMassEntity& Entity, TSubclassOf<UStatusEffectBase> StatusEffect) const;
+
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool HasAnyStatusEffect(const FStatusEffectsMassEntity& Entity) const;
+
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool HasAnyStatusEffectOfType(const FStatusEffectsMassEntity& Entity,
+	                              const EStatusEffectType StatusEffectType) const;
+
+	/**
+	 * Retrieves current stacks of a status effect of an entity
+	 *
+	 * @return The number of stacks. 0 if the status effect isn't applied
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	int32 GetStatusEffectStacks(const FStatusEffectsMassEntity& Entity,
+	                            TSubclassOf<UStatusEffectBase> StatusEffect) const;
+
+	/**
+	 * Retrieves the remaining time of a status effect of an entity
+	 *
+	 * @return The time in seconds. -1 if the status effect is infinite or isn't applied
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	float GetStatusEffectRemainingTime(const FStatusEffectsMassEntity& Entity,
+	                                   TSubclassOf<UStatusEffectBase> StatusEffect) const;
+
+	/**
+	 * Retrieves classes of all status effects applied to an entity
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	void GetAllStatusEffects(const FStatusEffectsMassEntity& Entity,
+	                         TArray<TSubclassOf<UStatusEffectBase>>& OutStatusEffects) const;
+
+	/**
+	 * Retrieves the definition of a status effect class by its registry ID. Safe to call from Mass processors
+	 *
+	 * @return A pointer to the definition. nullptr if no entity had the status effect applied
+	 */
+	const FStatusEffectsMassDefinition* FindDefinition(const uint16 ClassId) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Definitions indexed by class ID. Entries with no defaults weren't used yet
+	 */
+	TArray<FStatusEffectsMassDefinition> Definitions;
+
+	/**
+	 * Classes of definitions kept from being garbage collected
+	 */
+	UPROPERTY()
+	TArray<TSubclassOf<UStatusEffectBase>> DefinitionClasses;
+
+	const FStatusEffectsMassDefinition* GetOrAddDefinition(TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	FMassEntityManager* GetEntityManager() const;
+
+	FStatusEffectsMassFragment* GetFragment(const FMassEntityHandle Entity) const;
+
+	static uint16 GetClassId(TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	static void RefreshEntry(const FStatusEffectsMassDefinition& Definition, FStatusEffectsMassEntry& Entry);
+};
@@ -0,0 +1,100 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "MassEntityTypes.h"
+#include "StatusEffectsMassTypes.generated.h"
+
+namespace StatusEffectsMass::ProcessorGroupNames
+{
+	/**
+	 * The group of UStatusEffectsMassProcessor. Processors consuming AttributeDeltas add it to
+	 * ExecutionOrder.ExecuteAfter
+	 */
+	const FName StatusEffects = FName(TEXT("StatusEffects"));
+}
+
+/**
+ * Mass entity handle usable in Blueprints. Constructed implicitly from FMassEntityHandle.
+ * Blueprints make and break it by the index and serial number of the entity.
+ */
+USTRUCT(BlueprintType,
+	meta=(HasNativeMake="/Script/TrickyStatusEffectsMass.StatusEffectsMassSubsystem.MakeStatusEffectsMassEntity",
+		HasNativeBreak="/Script/TrickyStatusEffectsMass.StatusEffectsMassSubsystem.BreakStatusEffectsMassEntity"))
+struct TRICKYSTATUSEFFECTSMASS_API FStatusEffectsMassEntity
+{
+	GENERATED_BODY()
+
+	FStatusEffectsMassEntity() = default;
+
+	FStatusEffectsMassEntity(const FMassEntityHandle InHandle)
+		: Handle(InHandle)
+	{
+	}
+
+	UPROPERTY()
+	FMassEntityHandle Handle;
+};
+
+/**
+ * Compact state of a status effect applied to a Mass entity
+ */
+struct FStatusEffectsMassEntry
+{
+	/**
+	 * The registry ID of the status effect class
+	 */
+	uint16 ClassId = 0;
+
+	uint16 Stacks = 1;
+
+	/**
+	 * Negative for infinite status effects
+	 */
+	float RemainingTime = -1.f;
+
+	/**
+	 * Negative for status effects which aren't periodic
+	 */
+	float TimeToNextPeriod = -1.f;
+};
+
+/**
+ * Attribute change produced by periodic status effects of an entity during the last processing
+ */
+struct FStatusEffectsMassAttributeDelta
+{
+	FGameplayTag Attribute;
+
+	float Delta = 0.f;
+};
+
+/**
+ * Status effects applied to a Mass entity.
+ * Add it to entity templates to avoid moving entities between archetypes on the first apply.
+ */
+USTRUCT()
+struct TRICKYSTATUSEFFECTSMASS_API FStatusEffectsMassFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	TArray<FStatusEffectsMassEntry, TInlineAllocator<4>> Effects;
+
+	/**
+	 * Attribute changes of the current frame summed per attribute.
+	 * Processors consuming them should run after StatusEffectsMass::ProcessorGroupNames::StatusEffects.
+	 */
+	TArray<FStatusEffectsMassAttributeDelta, TInlineAllocator<2>> AttributeDeltas;
+};
+
+template <>
+struct TMassFragmentTraits<FStatusEffectsMassFragment> final
+{
+	// Inline arrays are bitwise relocatable, which is all archetype chunks need
+	enum
+	{
+		AuthorAcceptsItsNotTriviallyCopyable = true
+	};
+};
@@ -0,0 +1,9 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "Modules/ModuleManager.h"
+
+class FTrickyStatusEffectsMassModule : public IModuleInterface
+{
+};
@@ -0,0 +1,29 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+using UnrealBuildTool;
+
+public class TrickyStatusEffectsMass : ModuleRules
+{
+	public TrickyStatusEffectsMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"GameplayTags",
+				"MassEntity",
+				"TrickyStatusEffects",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+			}
+			);
+	}
+}
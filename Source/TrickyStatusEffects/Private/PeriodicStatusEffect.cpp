@@ -0,0 +1,106 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "PeriodicStatusEffect.h"
+
+#include "StatusEffectAttributeReceiver.h"
+#include "StatusEffectsSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void UPeriodicStatusEffect::BeginDestroy()
+{
+	UnregisterKernel();
+
+	Super::BeginDestroy();
+}
+
+float UPeriodicStatusEffect::CalculateMagnitude() const
+{
+	return CalculateMagnitudeForStacks(GetIsStackable() ? GetCurrentStacks() : 1);
+}
+
+float UPeriodicStatusEffect::CalculateMagnitudeForStacks(const int32 Stacks) const
+{
+	switch (StackScaling)
+	{
+	case EPeriodicStatusEffectStackScaling::Linear:
+		return Magnitude * Stacks;
+
+	case EPeriodicStatusEffectStackScaling::Curve:
+		{
+			const FRichCurve* Curve = StacksCurve.GetRichCurveConst();
+			return Curve ? Magnitude * Curve->Eval(Stacks, 1.f) : Magnitude;
+		}
+
+	default:
+		return Magnitude;
+	}
+}
+
+float UPeriodicStatusEffect::GetTimeToNextPeriod() const
+{
+	const UStatusEffectsSubsystem* Subsystem = KernelSubsystem.Get();
+	return Subsystem ? Subsystem->GetTimeToNextPeriod(this) : -1.f;
+}
+
+void UPeriodicStatusEffect::NativeActivate()
+{
+	Super::NativeActivate();
+
+	IStatusEffectAttributeReceiver* Receiver = Cast<IStatusEffectAttributeReceiver>(GetTargetActor());
+
+	if (!Receiver)
+	{
+		UE_LOG(LogStatusEffect, Warning, TEXT("%s won't change %s. Target %s doesn't implement IStatusEffectAttributeReceiver"),
+		       *GetName(),
+		       *Attribute.ToString(),
+		       *GetNameSafe(GetTargetActor()));
+		return;
+	}
+
+	UStatusEffectsSubsystem* Subsystem = UWorld::GetSubsystem<UStatusEffectsSubsystem>(GetWorld());
+
+	if (!IsValid(Subsystem))
+	{
+		return;
+	}
+
+	Subsystem->RegisterPeriodicStatusEffect(this, Receiver);
+}
+
+void UPeriodicStatusEffect::NativeDeactivate(AActor* Deactivator)
+{
+	UnregisterKernel();
+
+	Super::NativeDeactivate(Deactivator);
+}
+
+void UPeriodicStatusEffect::SerializeSnapshotPayload(FArchive& Ar)
+{
+	Super::SerializeSnapshotPayload(Ar);
+
+	float TimeToNextPeriod = Ar.IsSaving() ? GetTimeToNextPeriod() : -1.f;
+	Ar << TimeToNextPeriod;
+
+	if (Ar.IsLoading())
+	{
+		RestoredTimeToNextPeriod = TimeToNextPeriod;
+	}
+}
+
+void UPeriodicStatusEffect::UnregisterKernel()
+{
+	if (KernelIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (UStatusEffectsSubsystem* Subsystem = KernelSubsystem.Get())
+	{
+		Subsystem->UnregisterPeriodicStatusEffect(this);
+	}
+
+	KernelIndex = INDEX_NONE;
+	KernelSubsystem = nullptr;
+}
@@ -2,14 +2,66 @@
 
 
 #include "StatusEffectBase.h"
+#include "NativeStatusEffect.h"
+#include "Engine/World.h"
 #include "GameFramework/Actor.h"
+#include "StatusEffectsCsvProfiler.h"
+#include "StatusEffectsJournal.h"
 #include "StatusEffectsManagerComponent.h"
+#include "StatusEffectsRegistry.h"
+#include "StatusEffectsSnapshot.h"
+#include "StatusEffectsStats.h"
+#include "StatusEffectsSubsystem.h"
+#include "StatusEffectsTrace.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 DEFINE_LOG_CATEGORY(LogStatusEffect)
+DEFINE_LOG_CATEGORY(LogStatusEffectLifecycle)
+DEFINE_LOG_CATEGORY(LogStatusEffectStacks)
+DEFINE_LOG_CATEGORY(LogStatusEffectTimer)
+
+/**
+ * Calls a BlueprintNativeEvent through the Blueprint VM only if a Blueprint class overrides it.
+ * Otherwise calls its native implementation directly, or skips the call if the implementation is the empty default.
+ */
+#define DISPATCH_STATUSEFFECT_EVENT(EventName, ...) \
+	if (EnumHasAnyFlags(EventOverrides, EStatusEffectEventOverrides::EventName)) \
+	{ \
+		EventName(__VA_ARGS__); \
+	} \
+	else if (EnumHasAnyFlags(EventOverrides, EStatusEffectEventOverrides::NativeImplementation)) \
+	{ \
+		EventName##_Implementation(__VA_ARGS__); \
+	}
+
+/**
+ * Calls a statically dispatched handler of a TStatusEffect class, or dispatches the event as usual for other classes.
+ * Native dispatch is skipped entirely if the class doesn't declare the handler.
+ */
+#define DISPATCH_STATUSEFFECT_NATIVE_EVENT(EventName, ...) \
+	if (NativeDispatch) \
+	{ \
+		if (NativeDispatch->EventName) \
+		{ \
+			NativeDispatch->EventName(this, ##__VA_ARGS__); \
+		} \
+	} \
+	else DISPATCH_STATUSEFFECT_EVENT(EventName, ##__VA_ARGS__)
+
+namespace StatusEffectBase
+{
+	// Called only inside UE_LOG arguments, which aren't evaluated when the category is suppressed
+	FString GetActorName(const AActor* Actor)
+	{
+		return IsValid(Actor) ? Actor->GetActorNameOrLabel() : TEXT("NULL");
+	}
+}
 
 bool UStatusEffectBase::IncreaseStacks(const int32 Amount)
 {
-	if (!bIsStackable || Amount <= 0 || CurrentStacks >= MaxStacks)
+	// Without stack durations there's nothing to renew at MaxStacks
+	if (!bIsStackable || Amount <= 0 || (CurrentStacks >= MaxStacks && !HasStackDurations()))
 	{
 		return false;
 	}
@@ -17,20 +69,32 @@ bool UStatusEffectBase::IncreaseStacks(const int32 Amount)
 	CurrentStacks += Amount;
 	CurrentStacks = FMath::Min(CurrentStacks, MaxStacks);
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	const FString Message = FString::Printf(
-		TEXT("%s stacks increased by %d. Current stacks: %d"), *GetName(), Amount, CurrentStacks);
-	PrintLog(Message);
-#endif
+	if (HasStackDurations())
+	{
+		// Stacks above MaxStacks renew the oldest stacks, including when the status effect is already at MaxStacks
+		AddStackExpiryTimes(Amount);
+	}
+
+	UE_LOG(LogStatusEffectStacks, Verbose, TEXT("%s stacks increased by %d. Current stacks: %d"),
+	       *GetName(),
+	       Amount,
+	       CurrentStacks);
+
+	TRACE_STATUSEFFECT_STACKS_CHANGED(this, Amount);
+	RECORD_STATUSEFFECT_EVENT(StacksChanged, this, Amount);
+	DISPATCH_STATUSEFFECT_NATIVE_EVENT(HandleStacksIncreased, Amount);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectStacksIncreased.Broadcast(this, CurrentStacks);
+	}
 
-	HandleStacksIncreased(Amount);
-	OnStatusEffectStacksIncreased.Broadcast(this, CurrentStacks);
 	return true;
 }
 
 bool UStatusEffectBase::DecreaseStacks(const int32 Amount)
 {
-	if (bIsStackable || Amount <= 0)
+	if (!bIsStackable || Amount <= 0)
 	{
 		return false;
 	}
@@ -38,22 +102,29 @@ bool UStatusEffectBase::DecreaseStacks(const int32 Amount)
 	CurrentStacks -= Amount;
 	CurrentStacks = FMath::Max(CurrentStacks, 0);
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString Message = FString::Printf(
-		TEXT("%s stacks decreased by %d. Current stacks: %d"), *GetName(), Amount, CurrentStacks);
-	PrintLog(Message);
-#endif
+	if (HasStackDurations())
+	{
+		// Removed stacks are the ones which expire first
+		StackExpiryTimes.PopFront(FMath::Min(Amount, StackExpiryTimes.Num()));
+	}
 
-	HandleStacksDecreased(Amount);
-	OnStatusEffectStacksDecreased.Broadcast(this, CurrentStacks);
+	UE_LOG(LogStatusEffectStacks, Verbose, TEXT("%s stacks decreased by %d. Current stacks: %d"),
+	       *GetName(),
+	       Amount,
+	       CurrentStacks);
+
+	TRACE_STATUSEFFECT_STACKS_CHANGED(this, -Amount);
+	RECORD_STATUSEFFECT_EVENT(StacksChanged, this, -Amount);
+	DISPATCH_STATUSEFFECT_NATIVE_EVENT(HandleStacksDecreased, Amount);
 
-	if (CurrentStacks == 0)
 	{
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-		Message = FString::Printf(TEXT("%s stacks reached 0. Deactivation initiated"), *GetName());
-		PrintLog(Message);
-#endif
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectStacksDecreased.Broadcast(this, CurrentStacks);
+	}
 
+	if (CurrentStacks == 0)
+	{
+		UE_LOG(LogStatusEffectStacks, Verbose, TEXT("%s stacks reached 0. Deactivation initiated"), *GetName());
 		Deactivate(nullptr);
 	}
 
@@ -67,15 +138,80 @@ void UStatusEffectBase::Tick(float DeltaTime)
 		return;
 	}
 
-	ProcessEffectDurationTimer(DeltaTime);
-	ProcessTick(DeltaTime);
+	CSV_STATUSEFFECTS_SCOPE(Tick, ClassId);
+
+	if (NativeDispatch)
+	{
+		NativeDispatch->Tick(this, DeltaTime);
+	}
+	else
+	{
+		ProcessEffectDurationTimer(DeltaTime);
+
+		if (!QueueBudgetedTick(DeltaTime))
+		{
+			ProcessTick(DeltaTime);
+		}
+	}
+
 	LastFrameNumberWeTicked = GFrameCounter;
 }
 
+void UStatusEffectBase::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Blueprint subclasses can change settings the native dispatch was compiled with
+	if (NativeDispatch && GetClass() != NativeDispatch->GetStatusEffectClass())
+	{
+		NativeDispatch = nullptr;
+	}
+
+	if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		return;
+	}
+
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!Registry)
+	{
+		return;
+	}
+
+	if (const FStatusEffectCatalogEntry* CatalogEntry = Registry->GetCatalogEntry(GetClass()))
+	{
+		ClassId = CatalogEntry->ClassId;
+		EventOverrides = CatalogEntry->EventOverrides;
+	}
+}
+
+void UStatusEffectBase::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	FStatusEffectsMemoryUsage MemoryUsage;
+	AccumulateMemoryUsage(MemoryUsage);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(MemoryUsage.GetHeapBytes());
+}
+
+void UStatusEffectBase::AccumulateMemoryUsage(FStatusEffectsMemoryUsage& OutUsage) const
+{
+	OutUsage.ObjectBytes += GetClass()->GetStructureSize();
+	OutUsage.AddDelegate(OnStatusEffectDeactivated);
+	OutUsage.AddDelegate(OnStatusEffectRefreshed);
+	OutUsage.AddDelegate(OnStatusEffectStacksIncreased);
+	OutUsage.AddDelegate(OnStatusEffectStacksDecreased);
+	OutUsage.AddArray(EffectTags.GetGameplayTagArray());
+	OutUsage.AddArray(AttributeModifiers);
+	OutUsage.ContainerBytes += static_cast<SIZE_T>(StackExpiryTimes.Max()) * sizeof(float);
+	OutUsage.SlackBytes += static_cast<SIZE_T>(StackExpiryTimes.Max() - StackExpiryTimes.Num()) * sizeof(float);
+}
+
 bool UStatusEffectBase::IsTickable() const
 {
-	const bool bCanEverTick = bTickEffect || !bIsInfinite && Duration > 0.f;
-	return bCanEverTick && !IsUnreachable() && !IsTemplate(RF_ClassDefaultObject) && IsValid(this);
+	const bool bCanEverTick = NativeDispatch ? NativeDispatch->bCanEverTick : GetCanEverTick();
+	return bCanEverTick && !bIsReplicatedProxy && !IsUnreachable() && !IsTemplate(RF_ClassDefaultObject) && IsValid(this);
 }
 
 bool UStatusEffectBase::IsTickableWhenPaused() const
@@ -90,6 +226,11 @@ bool UStatusEffectBase::IsTickableInEditor() const
 
 ETickableTickType UStatusEffectBase::GetTickableTickType() const
 {
+	if (NativeDispatch && !NativeDispatch->bCanEverTick)
+	{
+		return ETickableTickType::Never;
+	}
+
 	return ETickableTickType::Conditional;
 }
 
@@ -133,12 +274,9 @@ bool UStatusEffectBase::Activate(UStatusEffectsManagerComponent* TargetManagerCo
 {
 	if (!IsValid(TargetManagerComponent) || !IsValid(TargetManagerComponent->GetOwner()))
 	{
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-		const FString Message = FString::Printf(
-			TEXT("%s activation failed. Target is invalid. Outer: %s"), *GetName(), *GetOuter()->GetName());
-		PrintError(Message);
-#endif
-
+		UE_LOG(LogStatusEffectLifecycle, Error, TEXT("%s activation failed. Target is invalid. Outer: %s"),
+		       *GetName(),
+		       *GetNameSafe(GetOuter()));
 		MarkAsGarbage();
 		return false;
 	}
@@ -147,23 +285,30 @@ bool UStatusEffectBase::Activate(UStatusEffectsManagerComponent* TargetManagerCo
 	TargetActor = TargetManagerComponent->GetOwner();
 	InstigatorActor = Instigator;
 
-	if (!CanBeActivated())
+	bool bCanBeActivated = true;
+
+	if (EnumHasAnyFlags(EventOverrides, EStatusEffectEventOverrides::CanBeActivated))
 	{
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-		const FString Message = FString::Printf(
-			TEXT("%s activation failed. CanBeActivated() check failed."), *GetName());
-		PrintLog(Message);
-#endif
+		bCanBeActivated = CanBeActivated();
+	}
+	else if (EnumHasAnyFlags(EventOverrides, EStatusEffectEventOverrides::NativeImplementation))
+	{
+		bCanBeActivated = CanBeActivated_Implementation();
+	}
 
+	if (!bCanBeActivated)
+	{
+		UE_LOG(LogStatusEffectLifecycle, Verbose, TEXT("%s activation failed. CanBeActivated() check failed."), *GetName());
 		MarkAsGarbage();
 		return false;
 	}
 
-	ActivateEffect();
+	DISPATCH_STATUSEFFECT_EVENT(ActivateEffect);
 
 	if (!bIsInfinite)
 	{
 		RemainingDuration = Duration;
+		UpdateTimerStamps();
 	}
 
 	if (bIsStackable)
@@ -171,29 +316,42 @@ bool UStatusEffectBase::Activate(UStatusEffectsManagerComponent* TargetManagerCo
 		CurrentStacks = InitialStacks;
 	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString TargetName, InstigatorName;
-	GetActorName(TargetActor, TargetName);
-	GetActorName(InstigatorActor, InstigatorName);
-	const FString DurationMessage = bIsInfinite ? TEXT("INFINITE") : FString::Printf(TEXT("%.2f sec"), Duration);
-	const FString StacksMessage = bIsStackable ? FString::Printf(TEXT("%d"), CurrentStacks) : TEXT("NO STACKS");
-	const FString Message = FString::Printf(
-		TEXT("%s activation success. Target: %s | Instigator: %s | Duration: %s | Stacks: %s"),
-		*GetName(),
-		*TargetName,
-		*InstigatorName,
-		*DurationMessage,
-		*StacksMessage);
-	PrintLog(Message);
-#endif
+	if (HasStackDurations())
+	{
+		ResetStackExpiryTimes(Duration);
+	}
+
+	NativeActivate();
+
+	UE_LOG(LogStatusEffectLifecycle, Verbose,
+	       TEXT("%s activation success. Target: %s | Instigator: %s | Duration: %s | Stacks: %s"),
+	       *GetName(),
+	       *StatusEffectBase::GetActorName(TargetActor),
+	       *StatusEffectBase::GetActorName(InstigatorActor),
+	       bIsInfinite ? TEXT("INFINITE") : *FString::Printf(TEXT("%.2f sec"), Duration),
+	       bIsStackable ? *FString::FromInt(CurrentStacks) : TEXT("NO STACKS"));
+
+	TRACE_STATUSEFFECT_ACTIVATED(this);
+	RECORD_STATUSEFFECT_EVENT(Activated, this);
 	return true;
 }
 
 void UStatusEffectBase::Refresh()
 {
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Refresh);
+
 	RefreshTimer();
-	RefreshStacks();
-	RefreshEffect();
+
+	{
+		RECORD_STATUSEFFECT_REFRESH_SCOPE(this);
+		RefreshStacks();
+	}
+
+	DISPATCH_STATUSEFFECT_NATIVE_EVENT(RefreshEffect);
+	TRACE_STATUSEFFECT_REFRESHED(this);
+	RECORD_STATUSEFFECT_EVENT(Refreshed, this);
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
 	OnStatusEffectRefreshed.Broadcast(this);
 }
 
@@ -204,32 +362,189 @@ void UStatusEffectBase::Deactivate(AActor* Deactivator)
 		return;
 	}
 
-	DeactivateEffect(Deactivator);
-
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString TargetName, InstigatorName, DeactivatorName;
-	GetActorName(TargetActor, TargetName);
-	GetActorName(InstigatorActor, InstigatorName);
-	GetActorName(Deactivator, DeactivatorName);
-	const FString Message = FString::Printf(
-		TEXT("%s deactivated by %s. Target: %s | Instigator: %s | RemainingTime: %.2f sec | RemainingStacks: %d"),
-		*GetName(),
-		*DeactivatorName,
-		*TargetName,
-		*InstigatorName,
-		GetRemainingTime(),
-		CurrentStacks);
-	PrintLog(Message);
-#endif
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Deactivate);
+	CSV_STATUSEFFECTS_SCOPE(Remove);
+
+	if (!bIsReplicatedProxy)
+	{
+		DISPATCH_STATUSEFFECT_EVENT(DeactivateEffect, Deactivator);
+		NativeDeactivate(Deactivator);
+	}
+
+	UE_LOG(LogStatusEffectLifecycle, Verbose,
+	       TEXT("%s deactivated by %s. Target: %s | Instigator: %s | RemainingTime: %.2f sec | RemainingStacks: %d"),
+	       *GetName(),
+	       *StatusEffectBase::GetActorName(Deactivator),
+	       *StatusEffectBase::GetActorName(TargetActor),
+	       *StatusEffectBase::GetActorName(InstigatorActor),
+	       GetRemainingTime(),
+	       CurrentStacks);
+
+	TRACE_STATUSEFFECT_DEACTIVATED(this, Deactivator);
+	RECORD_STATUSEFFECT_EVENT(Deactivated, this);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectDeactivated.Broadcast(this, Deactivator);
+	}
 
-	OnStatusEffectDeactivated.Broadcast(this, Deactivator);
 	MarkAsGarbage();
 	OnStatusEffectDeactivated.Clear();
 }
 
+bool UStatusEffectBase::ActivateAsProxy(UStatusEffectsManagerComponent* TargetManagerComponent,
+                                        AActor* Instigator,
+                                        const int32 Stacks,
+                                        const float StartTime,
+                                        const float EndTime)
+{
+	if (!IsValid(TargetManagerComponent) || !IsValid(TargetManagerComponent->GetOwner()))
+	{
+		UE_LOG(LogStatusEffectLifecycle, Error, TEXT("%s proxy activation failed. Target is invalid. Outer: %s"),
+		       *GetName(),
+		       *GetNameSafe(GetOuter()));
+		MarkAsGarbage();
+		return false;
+	}
+
+	bIsReplicatedProxy = true;
+	OwningManager = TargetManagerComponent;
+	TargetActor = TargetManagerComponent->GetOwner();
+	InstigatorActor = Instigator;
+	CurrentStacks = Stacks;
+	TimerStartTime = StartTime;
+	TimerEndTime = EndTime;
+	return true;
+}
+
+void UStatusEffectBase::ApplyReplicatedState(const int32 Stacks, const float StartTime, const float EndTime)
+{
+	if (!bIsReplicatedProxy)
+	{
+		return;
+	}
+
+	TimerStartTime = StartTime;
+	TimerEndTime = EndTime;
+
+	if (Stacks == CurrentStacks)
+	{
+		return;
+	}
+
+	const int32 PreviousStacks = CurrentStacks;
+	CurrentStacks = Stacks;
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+
+	if (CurrentStacks > PreviousStacks)
+	{
+		OnStatusEffectStacksIncreased.Broadcast(this, CurrentStacks);
+	}
+	else
+	{
+		OnStatusEffectStacksDecreased.Broadcast(this, CurrentStacks);
+	}
+}
+
+void UStatusEffectBase::SaveSnapshot(FStatusEffectSnapshotRecord& OutRecord)
+{
+	OutRecord.InstigatorPath = IsValid(InstigatorActor) ? FSoftObjectPath(InstigatorActor).ToString() : FString();
+	OutRecord.RemainingTime = GetRemainingTime();
+	OutRecord.TickPhase = TickDuration;
+	OutRecord.Stacks = CurrentStacks;
+	OutRecord.StackRemainingTimes.Reset();
+	OutRecord.Payload.Reset();
+
+	if (HasStackDurations())
+	{
+		for (int32 Index = 0; Index < StackExpiryTimes.Num(); ++Index)
+		{
+			OutRecord.StackRemainingTimes.Add(StackExpiryTimes[Index] - StackTimerTime);
+		}
+	}
+
+	FMemoryWriter Writer(OutRecord.Payload);
+	SerializeSnapshotPayload(Writer);
+}
+
+bool UStatusEffectBase::RestoreFromSnapshot(UStatusEffectsManagerComponent* TargetManagerComponent,
+                                            AActor* Instigator,
+                                            const FStatusEffectSnapshotRecord& Record)
+{
+	if (!IsValid(TargetManagerComponent) || !IsValid(TargetManagerComponent->GetOwner()))
+	{
+		UE_LOG(LogStatusEffectLifecycle, Error, TEXT("%s restore failed. Target is invalid. Outer: %s"),
+		       *GetName(),
+		       *GetNameSafe(GetOuter()));
+		MarkAsGarbage();
+		return false;
+	}
+
+	// A finite status effect without remaining time has already expired and its duration timer would never fire
+	if (!bIsInfinite && Record.RemainingTime <= 0.f)
+	{
+		UE_LOG(LogStatusEffectLifecycle, Warning, TEXT("%s restore skipped. Remaining time is %.2f sec"),
+		       *GetName(),
+		       Record.RemainingTime);
+		MarkAsGarbage();
+		return false;
+	}
+
+	OwningManager = TargetManagerComponent;
+	TargetActor = TargetManagerComponent->GetOwner();
+	InstigatorActor = Instigator;
+	RemainingDuration = bIsInfinite ? -1.f : Record.RemainingTime;
+	TickDuration = Record.TickPhase;
+	CurrentStacks = bIsStackable ? FMath::Clamp(Record.Stacks, 1, MaxStacks) : Record.Stacks;
+
+	if (HasStackDurations())
+	{
+		// Snapshots without stack times restore all stacks with the remaining time of the status effect
+		ResetStackExpiryTimes(FMath::Min(RemainingDuration, Duration));
+
+		if (Record.StackRemainingTimes.Num() == CurrentStacks)
+		{
+			for (int32 Index = 0; Index < CurrentStacks; ++Index)
+			{
+				StackExpiryTimes[Index] = FMath::Min(Record.StackRemainingTimes[Index], Duration);
+			}
+
+			RemainingDuration = StackExpiryTimes.Last();
+		}
+	}
+
+	UpdateTimerStamps();
+
+	if (!Record.Payload.IsEmpty())
+	{
+		FMemoryReader Reader(Record.Payload);
+		SerializeSnapshotPayload(Reader);
+	}
+
+	NativeActivate();
+
+	UE_LOG(LogStatusEffectLifecycle, Verbose, TEXT("%s restored. Remaining time: %.2f sec | Stacks: %d"),
+	       *GetName(),
+	       GetRemainingTime(),
+	       CurrentStacks);
+	return true;
+}
+
 float UStatusEffectBase::GetRemainingTime() const
 {
-	return bIsInfinite ? -1.f : RemainingDuration;
+	if (bIsInfinite)
+	{
+		return -1.f;
+	}
+
+	if (bIsReplicatedProxy)
+	{
+		const float ServerWorldTime = IsValid(OwningManager) ? OwningManager->GetServerWorldTime() : TimerEndTime;
+		return FMath::Max(0.f, TimerEndTime - ServerWorldTime);
+	}
+
+	return RemainingDuration;
 }
 
 float UStatusEffectBase::GetElapsedTime() const
@@ -239,6 +554,12 @@ float UStatusEffectBase::GetElapsedTime() const
 		return -1.f;
 	}
 
+	if (bIsReplicatedProxy)
+	{
+		const float ServerWorldTime = IsValid(OwningManager) ? OwningManager->GetServerWorldTime() : TimerStartTime;
+		return FMath::Max(0.f, ServerWorldTime - TimerStartTime);
+	}
+
 	if (TimerBehavior == EStatusEffectTimerRefreshBehavior::Extend)
 	{
 		return FMath::Max(0.f, MaxDuration - RemainingDuration);
@@ -247,9 +568,24 @@ float UStatusEffectBase::GetElapsedTime() const
 	return FMath::Max(0.f, Duration - RemainingDuration);
 }
 
+float UStatusEffectBase::GetStackRemainingTime(const int32 StackIndex) const
+{
+	if (!HasStackDurations() || bIsReplicatedProxy)
+	{
+		return GetRemainingTime();
+	}
+
+	if (!StackExpiryTimes.IsValidIndex(StackIndex))
+	{
+		return -1.f;
+	}
+
+	return FMath::Max(0.f, StackExpiryTimes[StackIndex] - StackTimerTime);
+}
+
 TStatId UStatusEffectBase::GetStatId() const
 {
-	RETURN_QUICK_DECLARE_CYCLE_STAT(UStatusEffectBase, STATGROUP_Tickables);
+	return StatusEffectsStats::GetClassStatId(GetClass());
 }
 
 void UStatusEffectBase::ProcessTick(float DeltaTime)
@@ -259,9 +595,14 @@ void UStatusEffectBase::ProcessTick(float DeltaTime)
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Tick);
+
+	TRACE_STATUSEFFECTS_SCOPE("StatusEffects.Tick");
+
 	if (TickInterval <= 0.f)
 	{
-		TickEffect(DeltaTime);
+		TRACE_STATUSEFFECT_TICKED(this, DeltaTime);
+		DISPATCH_STATUSEFFECT_NATIVE_EVENT(TickEffect, DeltaTime);
 		return;
 	}
 
@@ -272,10 +613,44 @@ void UStatusEffectBase::ProcessTick(float DeltaTime)
 	else
 	{
 		TickDuration += TickInterval;
-		TickEffect(TickInterval);
+		TRACE_STATUSEFFECT_TICKED(this, TickInterval);
+		DISPATCH_STATUSEFFECT_NATIVE_EVENT(TickEffect, TickInterval);
 	}
 }
 
+bool UStatusEffectBase::QueueBudgetedTick(float DeltaTime)
+{
+	if (!bTickEffect
+		|| TickPriority == EStatusEffectTickPriority::Critical
+		|| !UStatusEffectsSubsystem::IsTickBudgetEnabled())
+	{
+		return false;
+	}
+
+	UStatusEffectsSubsystem* Subsystem = UWorld::GetSubsystem<UStatusEffectsSubsystem>(GetWorld());
+
+	if (!IsValid(Subsystem))
+	{
+		return false;
+	}
+
+	// Expired this frame, the tick isn't needed anymore
+	if (!IsValid(this))
+	{
+		return true;
+	}
+
+	PendingTickDeltaTime += DeltaTime;
+
+	if (!bIsTickQueued)
+	{
+		bIsTickQueued = true;
+		Subsystem->QueueTick(this);
+	}
+
+	return true;
+}
+
 void UStatusEffectBase::ProcessEffectDurationTimer(float DeltaTime)
 {
 	if (bIsInfinite || Duration <= 0.f || RemainingDuration <= 0.f)
@@ -283,6 +658,14 @@ void UStatusEffectBase::ProcessEffectDurationTimer(float DeltaTime)
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Duration);
+
+	if (HasStackDurations())
+	{
+		ProcessStackExpiryTimes(DeltaTime);
+		return;
+	}
+
 	RemainingDuration -= DeltaTime;
 
 	if (RemainingDuration <= 0.f)
@@ -292,9 +675,62 @@ void UStatusEffectBase::ProcessEffectDurationTimer(float DeltaTime)
 	}
 }
 
+void UStatusEffectBase::ProcessStackExpiryTimes(float DeltaTime)
+{
+	StackTimerTime += DeltaTime;
+
+	int32 ExpiredStacks = 0;
+
+	while (ExpiredStacks < StackExpiryTimes.Num() && StackExpiryTimes[ExpiredStacks] <= StackTimerTime)
+	{
+		++ExpiredStacks;
+	}
+
+	// The status effect lasts until its newest stack expires
+	RemainingDuration = StackExpiryTimes.IsEmpty() ? -1.f : StackExpiryTimes.Last() - StackTimerTime;
+
+	if (ExpiredStacks > 0)
+	{
+		UE_LOG(LogStatusEffectTimer, Verbose, TEXT("%s %d stacks expired"), *GetName(), ExpiredStacks);
+		DecreaseStacks(ExpiredStacks);
+	}
+}
+
+void UStatusEffectBase::AddStackExpiryTimes(const int32 Amount)
+{
+	for (int32 Index = 0; Index < Amount; ++Index)
+	{
+		if (StackExpiryTimes.Num() >= MaxStacks)
+		{
+			StackExpiryTimes.PopFront();
+		}
+
+		StackExpiryTimes.Add(StackTimerTime + Duration);
+	}
+
+	if (Amount > 0)
+	{
+		RemainingDuration = Duration;
+		UpdateTimerStamps();
+	}
+}
+
+void UStatusEffectBase::ResetStackExpiryTimes(const float RemainingTime)
+{
+	StackExpiryTimes.Empty(MaxStacks);
+	StackTimerTime = 0.f;
+
+	for (int32 Index = 0; Index < CurrentStacks; ++Index)
+	{
+		StackExpiryTimes.Add(RemainingTime);
+	}
+
+	RemainingDuration = RemainingTime;
+}
+
 void UStatusEffectBase::RefreshTimer()
 {
-	if (bIsInfinite)
+	if (bIsInfinite || HasStackDurations())
 	{
 		return;
 	}
@@ -309,13 +745,10 @@ void UStatusEffectBase::RefreshTimer()
 	case EStatusEffectTimerRefreshBehavior::Reset:
 		{
 			RemainingDuration = Duration;
-
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-			const FString Message = FString::Printf(TEXT("%s timer refreshed. Remaining time: %.2f sec"),
-			                                        *GetName(),
-			                                        RemainingDuration);
-			PrintLog(Message);
-#endif
+			UpdateTimerStamps();
+			UE_LOG(LogStatusEffectTimer, Verbose, TEXT("%s timer refreshed. Remaining time: %.2f sec"),
+			       *GetName(),
+			       RemainingDuration);
 		}
 		break;
 
@@ -323,19 +756,29 @@ void UStatusEffectBase::RefreshTimer()
 		{
 			RemainingDuration += DeltaDuration;
 			RemainingDuration = FMath::Min(RemainingDuration, MaxDuration);
-
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-			const FString Message = FString::Printf(TEXT("%s timer extended by %.2f sec. Remaining time: %.2f sec"),
-			                                        *GetName(),
-			                                        DeltaDuration,
-			                                        RemainingDuration);
-			PrintLog(Message);
-#endif
+			UpdateTimerStamps();
+			UE_LOG(LogStatusEffectTimer, Verbose, TEXT("%s timer extended by %.2f sec. Remaining time: %.2f sec"),
+			       *GetName(),
+			       DeltaDuration,
+			       RemainingDuration);
 		}
 		break;
 	}
 }
 
+void UStatusEffectBase::UpdateTimerStamps()
+{
+	if (bIsInfinite || !IsValid(OwningManager))
+	{
+		TimerStartTime = TimerEndTime = -1.f;
+		return;
+	}
+
+	const float ServerWorldTime = OwningManager->GetServerWorldTime();
+	TimerStartTime = ServerWorldTime - GetElapsedTime();
+	TimerEndTime = ServerWorldTime + GetRemainingTime();
+}
+
 void UStatusEffectBase::RefreshStacks()
 {
 	if (!bIsStackable)
@@ -354,11 +797,15 @@ void UStatusEffectBase::RefreshStacks()
 		{
 			CurrentStacks = InitialStacks;
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-			const FString Message = FString::Printf(
-				TEXT("%s stacks reset. Remaining stacks: %d"), *GetName(), CurrentStacks);
-			PrintLog(Message);
-#endif
+			if (HasStackDurations())
+			{
+				ResetStackExpiryTimes(Duration);
+				UpdateTimerStamps();
+			}
+
+			UE_LOG(LogStatusEffectStacks, Verbose, TEXT("%s stacks reset. Remaining stacks: %d"),
+			       *GetName(),
+			       CurrentStacks);
 		}
 		break;
 
@@ -369,25 +816,3 @@ void UStatusEffectBase::RefreshStacks()
 		break;
 	}
 }
-
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-void UStatusEffectBase::PrintLog(const FString& Message)
-{
-	UE_LOG(LogStatusEffect, Log, TEXT("%s"), *Message);
-}
-
-void UStatusEffectBase::PrintWarning(const FString& Message)
-{
-	UE_LOG(LogStatusEffect, Warning, TEXT("%s"), *Message);
-}
-
-void UStatusEffectBase::PrintError(const FString& Message)
-{
-	UE_LOG(LogStatusEffect, Error, TEXT("%s"), *Message);
-}
-
-void UStatusEffectBase::GetActorName(AActor* Actor, FString& OutName)
-{
-	OutName = IsValid(Actor) ? Actor->GetActorNameOrLabel() : TEXT("NULL");
-}
-#endif
@@ -0,0 +1,122 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsCsvProfiler.h"
+
+#if CSV_PROFILER
+
+#include "StatusEffectsRegistry.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+CSV_DEFINE_CATEGORY(StatusEffects, true);
+
+namespace StatusEffectsCsvProfiler
+{
+	static bool bRecordClassTimings = false;
+
+	static FAutoConsoleVariableRef RecordClassTimingsVariable(
+		TEXT("StatusEffects.Csv.ClassTimings"),
+		bRecordClassTimings,
+		TEXT("Records tick timings of each status effect class into the StatusEffects CSV category."));
+}
+
+bool FStatusEffectsCsvProfiler::bIsCapturing = false;
+uint64 FStatusEffectsCsvProfiler::Timings[static_cast<uint8>(ETiming::Num)] = {};
+int32 FStatusEffectsCsvProfiler::Counters[static_cast<uint8>(ECounter::Num)] = {};
+TArray<uint64> FStatusEffectsCsvProfiler::ClassTickTimings;
+TArray<FName> FStatusEffectsCsvProfiler::ClassStatNames;
+FDelegateHandle FStatusEffectsCsvProfiler::EndFrameHandle;
+FStatusEffectsCsvScope* FStatusEffectsCsvScope::CurrentScope = nullptr;
+
+void FStatusEffectsCsvProfiler::Initialize()
+{
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FStatusEffectsCsvProfiler::HandleEndFrame);
+}
+
+void FStatusEffectsCsvProfiler::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+	bIsCapturing = false;
+}
+
+void FStatusEffectsCsvProfiler::AddTiming(const ETiming Timing, const uint16 ClassId, const uint64 Cycles)
+{
+	Timings[static_cast<uint8>(Timing)] += Cycles;
+
+	// Scopes without a class, e.g. periodic kernels, are recorded only in the total
+	if (Timing != ETiming::Tick
+		|| ClassId == UStatusEffectsRegistry::InvalidClassId
+		|| !StatusEffectsCsvProfiler::bRecordClassTimings)
+	{
+		return;
+	}
+
+	if (!ClassTickTimings.IsValidIndex(ClassId))
+	{
+		ClassTickTimings.SetNumZeroed(ClassId + 1);
+	}
+
+	ClassTickTimings[ClassId] += Cycles;
+}
+
+void FStatusEffectsCsvProfiler::HandleEndFrame()
+{
+	if (bIsCapturing)
+	{
+		auto ToMilliseconds = [](const uint64 Cycles)
+		{
+			return static_cast<float>(FPlatformTime::ToMilliseconds64(Cycles));
+		};
+
+		CSV_CUSTOM_STAT(StatusEffects, TickMs, ToMilliseconds(Timings[static_cast<uint8>(ETiming::Tick)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, ApplyMs, ToMilliseconds(Timings[static_cast<uint8>(ETiming::Apply)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, RemoveMs, ToMilliseconds(Timings[static_cast<uint8>(ETiming::Remove)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, ActiveEffects, Counters[static_cast<uint8>(ECounter::ActiveEffects)], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, Managers, Counters[static_cast<uint8>(ECounter::Managers)], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, Applied, Counters[static_cast<uint8>(ECounter::Applied)], ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StatusEffects, Removed, Counters[static_cast<uint8>(ECounter::Removed)], ECsvCustomStatOp::Set);
+
+		for (int32 ClassId = 0; ClassId < ClassTickTimings.Num(); ++ClassId)
+		{
+			if (ClassTickTimings[ClassId] == 0)
+			{
+				continue;
+			}
+
+			FCsvProfiler::RecordCustomStat(GetClassStatName(ClassId),
+			                               CSV_CATEGORY_INDEX(StatusEffects),
+			                               ToMilliseconds(ClassTickTimings[ClassId]),
+			                               ECsvCustomStatOp::Set);
+			ClassTickTimings[ClassId] = 0;
+		}
+	}
+
+	FMemory::Memzero(Timings);
+	Counters[static_cast<uint8>(ECounter::Applied)] = 0;
+	Counters[static_cast<uint8>(ECounter::Removed)] = 0;
+	bIsCapturing = FCsvProfiler::Get()->IsCapturing();
+}
+
+FName FStatusEffectsCsvProfiler::GetClassStatName(const uint16 ClassId)
+{
+	if (ClassStatNames.IsValidIndex(ClassId) && !ClassStatNames[ClassId].IsNone())
+	{
+		return ClassStatNames[ClassId];
+	}
+
+	if (!ClassStatNames.IsValidIndex(ClassId))
+	{
+		ClassStatNames.SetNum(ClassId + 1);
+	}
+
+	const UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+	const FString ClassName = IsValid(Registry)
+		                          ? Registry->GetClassPath(ClassId).GetAssetName().ToString()
+		                          : FString::FromInt(ClassId);
+	ClassStatNames[ClassId] = FName(FString::Printf(TEXT("TickMs/%s"), *ClassName));
+	return ClassStatNames[ClassId];
+}
+
+#endif
@@ -0,0 +1,140 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#if CSV_PROFILER
+
+CSV_DECLARE_CATEGORY_EXTERN(StatusEffects);
+
+/**
+ * Accumulates costs of status effects during a frame and records them into the CSV profiler at the end of the frame.
+ * Costs are accumulated only while a capture is running. Used on the game thread only.
+ */
+struct FStatusEffectsCsvProfiler
+{
+	enum class ETiming : uint8
+	{
+		Tick,
+		Apply,
+		Remove,
+		Num
+	};
+
+	enum class ECounter : uint8
+	{
+		// Persistent counters
+		ActiveEffects,
+		Managers,
+		// Counters reset every frame
+		Applied,
+		Removed,
+		Num
+	};
+
+	static void Initialize();
+
+	static void Shutdown();
+
+	static bool IsCapturing() { return bIsCapturing; }
+
+	static void AddTiming(const ETiming Timing, const uint16 ClassId, const uint64 Cycles);
+
+	static void Count(const ECounter Counter, const int32 Delta)
+	{
+		Counters[static_cast<uint8>(Counter)] += Delta;
+	}
+
+private:
+	static bool bIsCapturing;
+
+	static uint64 Timings[static_cast<uint8>(ETiming::Num)];
+
+	static int32 Counters[static_cast<uint8>(ECounter::Num)];
+
+	/**
+	 * Tick cycles by status effect class ID. Filled only if per class timings are enabled
+	 */
+	static TArray<uint64> ClassTickTimings;
+
+	static TArray<FName> ClassStatNames;
+
+	static FDelegateHandle EndFrameHandle;
+
+	static void HandleEndFrame();
+
+	static FName GetClassStatName(const uint16 ClassId);
+};
+
+/**
+ * Measures the scope if the CSV profiler is capturing.
+ * Timings are exclusive: time of nested scopes, e.g. a removal inside an apply, is subtracted from the outer scope.
+ */
+class FStatusEffectsCsvScope
+{
+public:
+	explicit FStatusEffectsCsvScope(const FStatusEffectsCsvProfiler::ETiming InTiming, const uint16 InClassId = 0)
+		: Timing(InTiming)
+		, ClassId(InClassId)
+		, StartCycles(FStatusEffectsCsvProfiler::IsCapturing() ? FPlatformTime::Cycles64() : 0)
+	{
+		if (StartCycles != 0)
+		{
+			OuterScope = CurrentScope;
+			CurrentScope = this;
+		}
+	}
+
+	~FStatusEffectsCsvScope()
+	{
+		if (StartCycles == 0)
+		{
+			return;
+		}
+
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		FStatusEffectsCsvProfiler::AddTiming(Timing, ClassId, Cycles - FMath::Min(Cycles, NestedCycles));
+
+		if (OuterScope)
+		{
+			OuterScope->NestedCycles += Cycles;
+		}
+
+		CurrentScope = OuterScope;
+	}
+
+private:
+	/**
+	 * The innermost measured scope. Scopes are used on the game thread only
+	 */
+	static FStatusEffectsCsvScope* CurrentScope;
+
+	FStatusEffectsCsvScope* OuterScope = nullptr;
+
+	FStatusEffectsCsvProfiler::ETiming Timing;
+
+	uint16 ClassId;
+
+	uint64 StartCycles;
+
+	/**
+	 * Cycles of scopes nested in this one
+	 */
+	uint64 NestedCycles = 0;
+};
+
+#define CSV_STATUSEFFECTS_SCOPE(Timing, ...) \
+	FStatusEffectsCsvScope PREPROCESSOR_JOIN(StatusEffectsCsvScope, __LINE__)( \
+		FStatusEffectsCsvProfiler::ETiming::Timing, ##__VA_ARGS__)
+
+#define CSV_STATUSEFFECTS_COUNT(Counter, Delta) \
+	FStatusEffectsCsvProfiler::Count(FStatusEffectsCsvProfiler::ECounter::Counter, Delta)
+
+#else
+
+#define CSV_STATUSEFFECTS_SCOPE(Timing, ...)
+#define CSV_STATUSEFFECTS_COUNT(Counter, Delta)
+
+#endif
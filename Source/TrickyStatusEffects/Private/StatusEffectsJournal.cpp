@@ -0,0 +1,515 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsJournal.h"
+
+#include "StatusEffectBase.h"
+#include "StatusEffectsManagerComponent.h"
+#include "StatusEffectsRegistry.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+#if STATUSEFFECTS_JOURNAL_ENABLED
+bool FStatusEffectsJournal::bIsRecording = false;
+
+/**
+ * Replays journaled events in real time against headless managers
+ */
+class FStatusEffectsJournalReplay : public FTSTickerObjectBase
+{
+public:
+	FStatusEffectsJournalReplay(UWorld* InWorld,
+	                            TArray<FStatusEffectJournalRecord>&& InRecords,
+	                            TMap<uint16, FString>&& InClassPaths)
+		: World(InWorld)
+		, Records(MoveTemp(InRecords))
+		, ClassPaths(MoveTemp(InClassPaths))
+	{
+	}
+
+	virtual ~FStatusEffectsJournalReplay() override
+	{
+		for (const TPair<uint32, TWeakObjectPtr<AActor>>& Actor : Actors)
+		{
+			if (Actor.Value.IsValid())
+			{
+				Actor.Value->Destroy();
+			}
+		}
+	}
+
+	virtual bool Tick(float DeltaTime) override
+	{
+		if (!World.IsValid())
+		{
+			return false;
+		}
+
+		ElapsedTime += DeltaTime;
+
+		while (Records.IsValidIndex(NextRecord) && Records[NextRecord].Time <= ElapsedTime)
+		{
+			ReplayRecord(Records[NextRecord++]);
+		}
+
+		if (NextRecord < Records.Num())
+		{
+			return true;
+		}
+
+		UE_LOG(LogStatusEffect, Display, TEXT("Status effects journal replay finished. Events: %d | Targets: %d"),
+		       Records.Num(),
+		       Managers.Num());
+		return false;
+	}
+
+private:
+	TWeakObjectPtr<UWorld> World;
+
+	TArray<FStatusEffectJournalRecord> Records;
+
+	TMap<uint16, FString> ClassPaths;
+
+	int32 NextRecord = 0;
+
+	float ElapsedTime = 0.f;
+
+	TMap<uint32, TWeakObjectPtr<AActor>> Actors;
+
+	TMap<uint32, TWeakObjectPtr<UStatusEffectsManagerComponent>> Managers;
+
+	TMap<uint32, TWeakObjectPtr<UStatusEffectBase>> StatusEffects;
+
+	TMap<uint16, TSubclassOf<UStatusEffectBase>> Classes;
+
+	void ReplayRecord(const FStatusEffectJournalRecord& Record)
+	{
+		if (Record.Event == EStatusEffectJournalEvent::Activated)
+		{
+			UStatusEffectsManagerComponent* Manager = GetOrCreateManager(Record.TargetId);
+			const TSubclassOf<UStatusEffectBase> StatusEffectClass = ResolveClass(Record.ClassId);
+
+			if (!IsValid(Manager) || !IsValid(StatusEffectClass))
+			{
+				return;
+			}
+
+			AActor* Instigator = Record.InstigatorId != 0 ? GetOrCreateActor(Record.InstigatorId) : nullptr;
+			StatusEffects.Add(Record.EffectId, Manager->ApplyStatusEffect(StatusEffectClass, Instigator));
+			return;
+		}
+
+		UStatusEffectBase* StatusEffect = StatusEffects.FindRef(Record.EffectId).Get();
+
+		if (!IsValid(StatusEffect))
+		{
+			return;
+		}
+
+		switch (Record.Event)
+		{
+		case EStatusEffectJournalEvent::Refreshed:
+			// Stack changes of a refresh aren't recorded separately and are repeated here
+			StatusEffect->Refresh();
+			break;
+
+		case EStatusEffectJournalEvent::StacksChanged:
+			if (Record.StacksDelta > 0)
+			{
+				StatusEffect->IncreaseStacks(Record.StacksDelta);
+			}
+			else
+			{
+				StatusEffect->DecreaseStacks(-Record.StacksDelta);
+			}
+			break;
+
+		case EStatusEffectJournalEvent::Deactivated:
+			StatusEffect->Deactivate(nullptr);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	AActor* GetOrCreateActor(const uint32 ObjectId)
+	{
+		if (AActor* Actor = Actors.FindRef(ObjectId).Get())
+		{
+			return Actor;
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		AActor* NewActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		Actors.Add(ObjectId, NewActor);
+		return NewActor;
+	}
+
+	UStatusEffectsManagerComponent* GetOrCreateManager(const uint32 TargetId)
+	{
+		if (UStatusEffectsManagerComponent* Manager = Managers.FindRef(TargetId).Get())
+		{
+			return Manager;
+		}
+
+		AActor* Target = GetOrCreateActor(TargetId);
+
+		if (!IsValid(Target))
+		{
+			return nullptr;
+		}
+
+		UStatusEffectsManagerComponent* NewManager = NewObject<UStatusEffectsManagerComponent>(Target);
+		NewManager->SetIsReplicated(false);
+		NewManager->RegisterComponent();
+		Managers.Add(TargetId, NewManager);
+		return NewManager;
+	}
+
+	TSubclassOf<UStatusEffectBase> ResolveClass(const uint16 ClassId)
+	{
+		if (const TSubclassOf<UStatusEffectBase>* StatusEffectClass = Classes.Find(ClassId))
+		{
+			return *StatusEffectClass;
+		}
+
+		TSubclassOf<UStatusEffectBase> StatusEffectClass = nullptr;
+
+		// Class paths of the journal take priority, as IDs can differ between builds
+		if (const FString* ClassPath = ClassPaths.Find(ClassId))
+		{
+			StatusEffectClass = TSoftClassPtr<UStatusEffectBase>(FSoftObjectPath(*ClassPath)).LoadSynchronous();
+		}
+		else if (UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get())
+		{
+			StatusEffectClass = Registry->ResolveClass(ClassId);
+		}
+
+		Classes.Add(ClassId, StatusEffectClass);
+		return StatusEffectClass;
+	}
+};
+
+namespace StatusEffectsJournal
+{
+	static int32 Capacity = 65536;
+
+	static FAutoConsoleVariableRef CapacityVariable(
+		TEXT("StatusEffects.Journal.Capacity"),
+		Capacity,
+		TEXT("The maximum number of events kept by the status effects journal. Applied when recording starts."));
+
+	static int32 bIsEnabled = 0;
+
+	static FAutoConsoleVariableRef EnableVariable(
+		TEXT("StatusEffects.Journal.Enable"),
+		bIsEnabled,
+		TEXT("Records status effect lifecycle events into the journal. Enabling discards previously recorded events."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+		{
+			if (bIsEnabled != 0)
+			{
+				FStatusEffectsJournal::Get().StartRecording(Capacity);
+			}
+			else
+			{
+				FStatusEffectsJournal::Get().StopRecording();
+			}
+		}));
+
+	static void Save(const TArray<FString>& Args)
+	{
+		const FString FilePath = Args.IsEmpty()
+			                         ? FPaths::ProfilingDir() / TEXT("StatusEffects")
+			                         / FString::Printf(TEXT("Journal-%s.sejournal"), *FDateTime::Now().ToString())
+			                         : Args[0];
+
+		if (!FStatusEffectsJournal::Get().SaveToFile(FilePath))
+		{
+			UE_LOG(LogStatusEffect, Error, TEXT("Failed to save status effects journal to %s"), *FilePath);
+			return;
+		}
+
+		UE_LOG(LogStatusEffect, Display, TEXT("Status effects journal saved to %s"), *FilePath);
+	}
+
+	static FAutoConsoleCommand SaveCommand(
+		TEXT("StatusEffects.Journal.Save"),
+		TEXT("Saves recorded status effect events. Usage: StatusEffects.Journal.Save [FilePath]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&Save));
+
+	static void Replay(const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.IsEmpty())
+		{
+			UE_LOG(LogStatusEffect, Warning, TEXT("Usage: StatusEffects.Journal.Replay FilePath"));
+			return;
+		}
+
+		TArray<FStatusEffectJournalRecord> Records;
+		TMap<uint16, FString> ClassPaths;
+
+		if (!FStatusEffectsJournal::LoadFromFile(Args[0], Records, ClassPaths))
+		{
+			UE_LOG(LogStatusEffect, Error, TEXT("Failed to load status effects journal from %s"), *Args[0]);
+			return;
+		}
+
+		FStatusEffectsJournal::Get().StartReplay(World, MoveTemp(Records), MoveTemp(ClassPaths));
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs ReplayCommand(
+		TEXT("StatusEffects.Journal.Replay"),
+		TEXT("Replays a saved status effects journal against headless managers in the current world."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Replay));
+
+	static FAutoConsoleCommand StopReplayCommand(
+		TEXT("StatusEffects.Journal.StopReplay"),
+		TEXT("Stops the status effects journal replay and destroys its actors."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FStatusEffectsJournal::Get().StopReplay();
+		}));
+}
+
+FArchive& operator<<(FArchive& Ar, FStatusEffectJournalRecord& Record)
+{
+	uint8 Event = static_cast<uint8>(Record.Event);
+
+	Ar << Record.Time;
+	Ar << Record.EffectId;
+	Ar << Record.TargetId;
+	Ar << Record.InstigatorId;
+	Ar << Record.ClassId;
+	Ar << Event;
+	Ar << Record.Stacks;
+	Ar << Record.StacksDelta;
+	Ar << Record.RemainingTime;
+
+	if (Ar.IsLoading() && Event > static_cast<uint8>(EStatusEffectJournalEvent::Deactivated))
+	{
+		Ar.SetError();
+	}
+
+	Record.Event = static_cast<EStatusEffectJournalEvent>(Event);
+	return Ar;
+}
+
+FStatusEffectsJournal::~FStatusEffectsJournal() = default;
+
+FStatusEffectsJournal& FStatusEffectsJournal::Get()
+{
+	static FStatusEffectsJournal Journal;
+	return Journal;
+}
+
+void FStatusEffectsJournal::StartRecording(const int32 Capacity)
+{
+	check(IsInGameThread());
+
+	RingBuffer.SetNum(FMath::Max(Capacity, 1));
+	NextIndex = 0;
+	NumRecords = 0;
+	StartTime = FPlatformTime::Seconds();
+	bIsRecording = true;
+
+	UE_LOG(LogStatusEffect, Display, TEXT("Status effects journal recording started. Capacity: %d"), RingBuffer.Num());
+}
+
+void FStatusEffectsJournal::StopRecording()
+{
+	bIsRecording = false;
+
+	UE_LOG(LogStatusEffect, Display, TEXT("Status effects journal recording stopped. Events: %d"), NumRecords);
+}
+
+void FStatusEffectsJournal::Record(const EStatusEffectJournalEvent Event,
+                                   const UStatusEffectBase* StatusEffect,
+                                   const int32 StacksDelta)
+{
+	if (!bIsRecording || !StatusEffect || StatusEffect->GetIsReplicatedProxy())
+	{
+		return;
+	}
+
+	if (Event == EStatusEffectJournalEvent::StacksChanged && StatusEffect == RefreshingStatusEffect)
+	{
+		return;
+	}
+
+	const AActor* TargetActor = StatusEffect->GetTargetActor();
+	const AActor* InstigatorActor = StatusEffect->GetInstigatorActor();
+
+	FStatusEffectJournalRecord& NewRecord = RingBuffer[NextIndex];
+	NewRecord.Time = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+	NewRecord.EffectId = StatusEffect->GetUniqueID();
+	NewRecord.TargetId = TargetActor ? TargetActor->GetUniqueID() : 0;
+	NewRecord.InstigatorId = InstigatorActor ? InstigatorActor->GetUniqueID() : 0;
+	NewRecord.ClassId = StatusEffect->GetClassId();
+	NewRecord.Event = Event;
+	NewRecord.Stacks = StatusEffect->GetCurrentStacks();
+	NewRecord.StacksDelta = StacksDelta;
+	NewRecord.RemainingTime = StatusEffect->GetRemainingTime();
+
+	NextIndex = (NextIndex + 1) % RingBuffer.Num();
+	NumRecords = FMath::Min(NumRecords + 1, RingBuffer.Num());
+}
+
+void FStatusEffectsJournal::GetRecords(TArray<FStatusEffectJournalRecord>& OutRecords) const
+{
+	OutRecords.Reset(NumRecords);
+
+	// The buffer starts from the oldest event once it's wrapped
+	const int32 FirstIndex = NumRecords < RingBuffer.Num() ? 0 : NextIndex;
+
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		OutRecords.Add(RingBuffer[(FirstIndex + Index) % RingBuffer.Num()]);
+	}
+}
+
+bool FStatusEffectsJournal::SaveToFile(const FString& FilePath) const
+{
+	TArray<FStatusEffectJournalRecord> Records;
+	GetRecords(Records);
+
+	TMap<uint16, FString> ClassPaths;
+
+	if (const UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get())
+	{
+		for (const FStatusEffectJournalRecord& Record : Records)
+		{
+			if (!ClassPaths.Contains(Record.ClassId))
+			{
+				ClassPaths.Add(Record.ClassId, Registry->GetClassPath(Record.ClassId).ToString());
+			}
+		}
+	}
+
+	const TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+
+	if (!Writer)
+	{
+		return false;
+	}
+
+	uint32 SavedMagic = Magic;
+	uint16 Version = static_cast<uint16>(EVersion::Latest);
+	int32 NumClasses = ClassPaths.Num();
+	*Writer << SavedMagic;
+	*Writer << Version;
+	*Writer << NumClasses;
+
+	for (TPair<uint16, FString>& ClassPath : ClassPaths)
+	{
+		*Writer << ClassPath.Key;
+		*Writer << ClassPath.Value;
+	}
+
+	int32 NumSavedRecords = Records.Num();
+	*Writer << NumSavedRecords;
+
+	for (FStatusEffectJournalRecord& Record : Records)
+	{
+		*Writer << Record;
+	}
+
+	return Writer->Close();
+}
+
+bool FStatusEffectsJournal::LoadFromFile(const FString& FilePath,
+                                         TArray<FStatusEffectJournalRecord>& OutRecords,
+                                         TMap<uint16, FString>& OutClassPaths)
+{
+	const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+
+	if (!Reader)
+	{
+		return false;
+	}
+
+	uint32 SavedMagic = 0;
+	uint16 Version = 0;
+	*Reader << SavedMagic;
+	*Reader << Version;
+
+	if (SavedMagic != Magic || Version == 0 || Version > static_cast<uint16>(EVersion::Latest))
+	{
+		return false;
+	}
+
+	int32 NumClasses = 0;
+	*Reader << NumClasses;
+
+	if (NumClasses < 0 || NumClasses > Reader->TotalSize())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < NumClasses && !Reader->IsError(); ++Index)
+	{
+		uint16 ClassId = 0;
+		FString ClassPath;
+		*Reader << ClassId;
+		*Reader << ClassPath;
+		OutClassPaths.Add(ClassId, MoveTemp(ClassPath));
+	}
+
+	int32 NumLoadedRecords = 0;
+	*Reader << NumLoadedRecords;
+
+	if (NumLoadedRecords < 0 || NumLoadedRecords > Reader->TotalSize())
+	{
+		return false;
+	}
+
+	OutRecords.SetNum(NumLoadedRecords);
+
+	for (FStatusEffectJournalRecord& Record : OutRecords)
+	{
+		*Reader << Record;
+
+		if (Reader->IsError())
+		{
+			return false;
+		}
+	}
+
+	return !Reader->IsError();
+}
+
+bool FStatusEffectsJournal::StartReplay(UWorld* World,
+                                        TArray<FStatusEffectJournalRecord>&& Records,
+                                        TMap<uint16, FString>&& ClassPaths)
+{
+	if (!IsValid(World))
+	{
+		return false;
+	}
+
+	StopReplay();
+
+	if (!EnginePreExitHandle.IsValid())
+	{
+		// The journal outlives the engine, so the replay must release its actors and ticker before exit
+		EnginePreExitHandle = FCoreDelegates::OnEnginePreExit.AddRaw(this, &FStatusEffectsJournal::StopReplay);
+	}
+
+	UE_LOG(LogStatusEffect, Display, TEXT("Status effects journal replay started. Events: %d"), Records.Num());
+	Replay = MakeUnique<FStatusEffectsJournalReplay>(World, MoveTemp(Records), MoveTemp(ClassPaths));
+	return true;
+}
+
+void FStatusEffectsJournal::StopReplay()
+{
+	Replay.Reset();
+}
+#endif
@@ -5,6 +5,7 @@
 
 #include "StatusEffectsManagerComponent.h"
 #include "StatusEffectBase.h"
+#include "StatusEffectsRegistry.h"
 
 UStatusEffectsManagerComponent* UStatusEffectsLibrary::GetStatusEffectsManager(AActor* Target)
 {
@@ -35,6 +36,50 @@ UStatusEffectBase* UStatusEffectsLibrary::ApplyStatusEffect(AActor* Target,
 	return StatusEffectsManager->ApplyStatusEffect(StatusEffect, Instigator);
 }
 
+UStatusEffectBase* UStatusEffectsLibrary::ApplySoftStatusEffect(AActor* Target,
+                                                                TSoftClassPtr<UStatusEffectBase> StatusEffect,
+                                                                AActor* Instigator)
+{
+	if (!IsValid(Target) || StatusEffect.IsNull())
+	{
+		return nullptr;
+	}
+
+	UStatusEffectsManagerComponent* StatusEffectsManager = GetStatusEffectsManager(Target);
+
+	if (!IsValid(StatusEffectsManager))
+	{
+		return nullptr;
+	}
+
+	return StatusEffectsManager->ApplySoftStatusEffect(StatusEffect, Instigator);
+}
+
+void UStatusEffectsLibrary::PreloadStatusEffects(const FName PreloadGroup,
+                                                 const TArray<TSoftClassPtr<UStatusEffectBase>>& StatusEffects)
+{
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!IsValid(Registry))
+	{
+		return;
+	}
+
+	Registry->PreloadStatusEffectClasses(PreloadGroup, StatusEffects, FOnStatusEffectsPreloadedDynamicSignature());
+}
+
+void UStatusEffectsLibrary::ReleasePreloadedStatusEffects(const FName PreloadGroup)
+{
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!IsValid(Registry))
+	{
+		return;
+	}
+
+	Registry->ReleasePreloadedStatusEffectClasses(PreloadGroup);
+}
+
 void UStatusEffectsLibrary::RefreshAllStatusEffects(AActor* Target)
 {
 	if (!IsValid(Target))
@@ -4,17 +4,78 @@
 #include "StatusEffectsManagerComponent.h"
 
 #include "StatusEffectBase.h"
+#include "StatusEffectsCsvProfiler.h"
+#include "StatusEffectsRegistry.h"
+#include "StatusEffectsStats.h"
+#include "StatusEffectsTrace.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "UObject/UObjectIterator.h"
+
+static void DumpStatusEffects(UWorld* World)
+{
+	for (TObjectIterator<UStatusEffectsManagerComponent> It; It; ++It)
+	{
+		const UStatusEffectsManagerComponent* Manager = *It;
+
+		if (!IsValid(Manager) || Manager->GetWorld() != World || !IsValid(Manager->GetOwner()))
+		{
+			continue;
+		}
+
+		TArray<UStatusEffectBase*> StatusEffects;
+		Manager->GetAllStatusEffects(StatusEffects);
+		UE_LOG(LogStatusEffect, Display, TEXT("%s: %d status effects"),
+		       *Manager->GetOwner()->GetActorNameOrLabel(),
+		       StatusEffects.Num());
+
+		for (const UStatusEffectBase* StatusEffect : StatusEffects)
+		{
+			UE_LOG(LogStatusEffect, Display, TEXT("    %s | Stacks: %d | RemainingTime: %.2f sec%s"),
+			       *StatusEffect->GetClass()->GetName(),
+			       StatusEffect->GetCurrentStacks(),
+			       StatusEffect->GetRemainingTime(),
+			       StatusEffect->GetIsReplicatedProxy() ? TEXT(" | PROXY") : TEXT(""));
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorld DumpStatusEffectsCommand(
+	TEXT("StatusEffects.Dump"),
+	TEXT("Prints status effects of all managers in the current world. Replicated proxies are marked as PROXY."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpStatusEffects));
 
 
 UStatusEffectsManagerComponent::UStatusEffectsManagerComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+	ReplicatedStatusEffects.OwningManager = this;
+	OwnerReplicatedStatusEffects.OwningManager = this;
+}
+
+void UStatusEffectsManagerComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	INC_DWORD_STAT(STAT_StatusEffects_NumManagers);
+	CSV_STATUSEFFECTS_COUNT(Managers, 1);
+}
+
+void UStatusEffectsManagerComponent::OnUnregister()
+{
+	DEC_DWORD_STAT(STAT_StatusEffects_NumManagers);
+	CSV_STATUSEFFECTS_COUNT(Managers, -1);
+
+	Super::OnUnregister();
 }
 
 void UStatusEffectsManagerComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 {
 	Super::OnComponentDestroyed(bDestroyingHierarchy);
 
+	PendingStatusEffects.Empty();
+
 	if (AppliedStatusEffects.IsEmpty())
 	{
 		return;
@@ -23,6 +84,64 @@ void UStatusEffectsManagerComponent::OnComponentDestroyed(bool bDestroyingHierar
 	RemoveAllStatusEffects(GetOwner());
 }
 
+void UStatusEffectsManagerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UStatusEffectsManagerComponent, ReplicatedStatusEffects);
+	DOREPLIFETIME_CONDITION(UStatusEffectsManagerComponent, OwnerReplicatedStatusEffects, COND_OwnerOnly);
+	DOREPLIFETIME(UStatusEffectsManagerComponent, RegistryHash);
+}
+
+void UStatusEffectsManagerComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	FStatusEffectsMemoryUsage MemoryUsage;
+	AccumulateMemoryUsage(MemoryUsage);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(MemoryUsage.GetHeapBytes());
+
+	// Status effects are subobjects of the manager and report their own size when subobjects are included
+}
+
+void UStatusEffectsManagerComponent::AccumulateMemoryUsage(FStatusEffectsMemoryUsage& OutUsage) const
+{
+	OutUsage.ObjectBytes += GetClass()->GetStructureSize();
+	OutUsage.AddDelegate(OnStatusEffectApplied);
+	OutUsage.AddDelegate(OnStatusEffectRemoved);
+	OutUsage.AddDelegate(OnStatusEffectRefreshed);
+	OutUsage.AddArray(AppliedStatusEffects);
+	OutUsage.AddArray(PendingStatusEffects);
+
+	for (const FReplicatedStatusEffectsList* List : {&ReplicatedStatusEffects, &OwnerReplicatedStatusEffects})
+	{
+		OutUsage.AddArray(List->Items);
+		OutUsage.ContainerBytes += List->ItemMap.GetAllocatedSize();
+	}
+
+	OutUsage.ContainerBytes += AttributeAggregates.GetAllocatedSize();
+	OutUsage.ContainerBytes += ActiveClassIds.GetAllocatedSize();
+	OutUsage.ContainerBytes += ExclusiveGroupSlots.GetAllocatedSize();
+
+	for (const TPair<FGameplayTag, FAttributeAggregate>& Pair : AttributeAggregates)
+	{
+		OutUsage.AddArray(Pair.Value.StatusEffects);
+	}
+}
+
+float UStatusEffectsManagerComponent::GetServerWorldTime() const
+{
+	const UWorld* World = GetWorld();
+
+	if (!IsValid(World))
+	{
+		return 0.f;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	return IsValid(GameState) ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
 UStatusEffectBase* UStatusEffectsManagerComponent::ApplyStatusEffect(TSubclassOf<UStatusEffectBase> StatusEffect,
                                                                      AActor* Instigator)
 {
@@ -31,7 +150,24 @@ UStatusEffectBase* UStatusEffectsManagerComponent::ApplyStatusEffect(TSubclassOf
 		return nullptr;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Apply);
+	TRACE_STATUSEFFECTS_SCOPE("StatusEffects.Apply");
+	CSV_STATUSEFFECTS_SCOPE(Apply);
+
+	if (IsBlockedByInteractionRules(StatusEffect))
+	{
+		return nullptr;
+	}
+
 	const UStatusEffectBase* StatusEffectCDO = StatusEffect->GetDefaultObject<UStatusEffectBase>();
+
+	UStatusEffectBase* ReplacedStatusEffect = nullptr;
+
+	if (!ResolveExclusiveGroup(StatusEffectCDO, Instigator, ReplacedStatusEffect))
+	{
+		return nullptr;
+	}
+
 	UStatusEffectBase* TargetStatusEffect = nullptr;
 
 	switch (StatusEffectCDO->GetEffectScope())
@@ -76,9 +212,51 @@ UStatusEffectBase* UStatusEffectsManagerComponent::ApplyStatusEffect(TSubclassOf
 		break;
 	}
 
+	if (!IsValid(TargetStatusEffect))
+	{
+		return nullptr;
+	}
+
+	// The replaced member is deactivated only after its replacement took the slot, so a failed application keeps it
+	if (IsValid(ReplacedStatusEffect) && ReplacedStatusEffect != TargetStatusEffect)
+	{
+		ReplacedStatusEffect->Deactivate(Instigator);
+	}
+
+	// Cancellations run only once the status effect is applied, so a failed application doesn't remove anything
+	CancelByInteractionRules(TargetStatusEffect, Instigator);
 	return TargetStatusEffect;
 }
 
+UStatusEffectBase* UStatusEffectsManagerComponent::ApplySoftStatusEffect(TSoftClassPtr<UStatusEffectBase> StatusEffect,
+                                                                         AActor* Instigator)
+{
+	if (StatusEffect.IsNull())
+	{
+		return nullptr;
+	}
+
+	if (UClass* StatusEffectClass = StatusEffect.Get())
+	{
+		return ApplyStatusEffect(StatusEffectClass, Instigator);
+	}
+
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!IsValid(Registry))
+	{
+		return nullptr;
+	}
+
+	PendingStatusEffects.Add({StatusEffect, Instigator});
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [this, StatusEffect]()
+	{
+		HandleStatusEffectClassLoaded(StatusEffect);
+	});
+	Registry->RequestAsyncLoad(StatusEffect, OnLoaded);
+	return nullptr;
+}
+
 void UStatusEffectsManagerComponent::RefreshAllStatusEffects()
 {
 	if (AppliedStatusEffects.IsEmpty())
@@ -195,7 +373,14 @@ bool UStatusEffectsManagerComponent::RemoveStatusEffectFromInstigator(TSubclassO
 
 void UStatusEffectsManagerComponent::RemoveAllStatusEffects(AActor* Remover)
 {
-	RemoveGivenStatusEffects(AppliedStatusEffects, Remover);
+	if (AppliedStatusEffects.IsEmpty())
+	{
+		return;
+	}
+
+	// Deactivated status effects are removed from AppliedStatusEffects, so a copy is iterated
+	const TArray<UStatusEffectBase*> StatusEffects = AppliedStatusEffects;
+	RemoveGivenStatusEffects(StatusEffects, Remover);
 }
 
 void UStatusEffectsManagerComponent::RemoveAllStatusEffectsFromInstigator(AActor* Remover, AActor* Instigator) const
@@ -266,6 +451,79 @@ void UStatusEffectsManagerComponent::RemoveAllStatusEffectsOfTypeFromInstigator(
 	RemoveGivenStatusEffects(StatusEffects, Remover);
 }
 
+void UStatusEffectsManagerComponent::SaveStatusEffectsSnapshot(TArray<uint8>& OutData) const
+{
+	FStatusEffectsSnapshot Snapshot;
+	Snapshot.Records.Reserve(AppliedStatusEffects.Num());
+
+	for (UStatusEffectBase* StatusEffect : AppliedStatusEffects)
+	{
+		if (!IsValid(StatusEffect) || StatusEffect->GetIsReplicatedProxy())
+		{
+			continue;
+		}
+
+		FStatusEffectSnapshotRecord& Record = Snapshot.Records.AddDefaulted_GetRef();
+		Record.ClassPath = StatusEffect->GetClass()->GetPathName();
+		StatusEffect->SaveSnapshot(Record);
+	}
+
+	Snapshot.Encode(OutData);
+}
+
+int32 UStatusEffectsManagerComponent::RestoreStatusEffectsSnapshot(const TArray<uint8>& Data)
+{
+	FStatusEffectsSnapshot Snapshot;
+
+	if (!Snapshot.Decode(Data))
+	{
+		UE_LOG(LogStatusEffect, Error, TEXT("%s failed to decode status effects snapshot"), *GetName());
+		return 0;
+	}
+
+	return RestoreStatusEffectsFromSnapshot(Snapshot);
+}
+
+int32 UStatusEffectsManagerComponent::RestoreStatusEffectsFromSnapshot(const FStatusEffectsSnapshot& Snapshot)
+{
+	check(IsInGameThread());
+
+	int32 NumRestored = 0;
+
+	for (const FStatusEffectSnapshotRecord& Record : Snapshot.Records)
+	{
+		const TSoftClassPtr<UStatusEffectBase> SoftClass{FSoftObjectPath(Record.ClassPath)};
+		const TSubclassOf<UStatusEffectBase> StatusEffectClass = SoftClass.LoadSynchronous();
+
+		if (!IsValid(StatusEffectClass))
+		{
+			UE_LOG(LogStatusEffect, Warning, TEXT("%s can't restore %s. Class not found"),
+			       *GetName(),
+			       *Record.ClassPath);
+			continue;
+		}
+
+		AActor* Instigator = nullptr;
+
+		if (!Record.InstigatorPath.IsEmpty())
+		{
+			Instigator = Cast<AActor>(FSoftObjectPath(Record.InstigatorPath).ResolveObject());
+		}
+
+		UStatusEffectBase* NewStatusEffect = NewObject<UStatusEffectBase>(this, StatusEffectClass);
+
+		if (!IsValid(NewStatusEffect) || !NewStatusEffect->RestoreFromSnapshot(this, Instigator, Record))
+		{
+			continue;
+		}
+
+		RegisterStatusEffect(NewStatusEffect, Instigator);
+		++NumRestored;
+	}
+
+	return NumRestored;
+}
+
 bool UStatusEffectsManagerComponent::HasStatusEffect(TSubclassOf<UStatusEffectBase> StatusEffect) const
 {
 	if (AppliedStatusEffects.IsEmpty() || !IsValid(StatusEffect))
@@ -348,6 +606,11 @@ bool UStatusEffectsManagerComponent::HasAnyStatusEffectOfTypeFromInstigator(cons
 	return AppliedStatusEffects.ContainsByPredicate(Predicate);
 }
 
+UStatusEffectBase* UStatusEffectsManagerComponent::GetStatusEffectInGroup(const FGameplayTag ExclusiveGroup) const
+{
+	return ExclusiveGroupSlots.FindRef(ExclusiveGroup);
+}
+
 UStatusEffectBase* UStatusEffectsManagerComponent::GetStatusEffect(TSubclassOf<UStatusEffectBase> StatusEffect) const
 {
 	if (!IsValid(StatusEffect))
@@ -391,6 +654,29 @@ void UStatusEffectsManagerComponent::GetAllStatusEffects(TArray<UStatusEffectBas
 	OutStatusEffects = AppliedStatusEffects;
 }
 
+float UStatusEffectsManagerComponent::GetModifiedAttributeValue(const FGameplayTag Attribute,
+                                                                const float BaseValue) const
+{
+	FAttributeAggregate* Aggregate = AttributeAggregates.Find(Attribute);
+
+	if (!Aggregate)
+	{
+		return BaseValue;
+	}
+
+	if (Aggregate->bIsDirty)
+	{
+		AggregateAttributeModifiers(Attribute, *Aggregate);
+	}
+
+	if (Aggregate->bHasOverride)
+	{
+		return Aggregate->OverrideValue;
+	}
+
+	return (BaseValue + Aggregate->Addition) * Aggregate->Multiplier;
+}
+
 void UStatusEffectsManagerComponent::GetAllStatusEffectsOfClass(TArray<UStatusEffectBase*>& OutStatusEffects,
                                                                 TSubclassOf<UStatusEffectBase> StatusEffect) const
 {
@@ -482,8 +768,25 @@ void UStatusEffectsManagerComponent::HandleStatusEffectDeactivated(UStatusEffect
 		return;
 	}
 
-	OnStatusEffectRemoved.Broadcast(this, StatusEffect, Deactivator);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectRemoved.Broadcast(this, StatusEffect, Deactivator);
+	}
+
 	AppliedStatusEffects.Remove(StatusEffect);
+	RemoveActiveClassId(StatusEffect);
+	RemoveFromExclusiveGroup(StatusEffect);
+
+	RemoveAttributeModifiers(StatusEffect);
+	DEC_DWORD_STAT(STAT_StatusEffects_NumActive);
+	CSV_STATUSEFFECTS_COUNT(ActiveEffects, -1);
+	INC_DWORD_STAT(STAT_StatusEffects_NumDeactivated);
+	CSV_STATUSEFFECTS_COUNT(Removed, 1);
+
+	if (FReplicatedStatusEffectsList* ReplicatedList = GetReplicatedStatusEffectsList(StatusEffect))
+	{
+		ReplicatedList->RemoveEntry(StatusEffect);
+	}
 }
 
 void UStatusEffectsManagerComponent::HandleStatusEffectRefreshed(UStatusEffectBase* StatusEffect)
@@ -493,9 +796,147 @@ void UStatusEffectsManagerComponent::HandleStatusEffectRefreshed(UStatusEffectBa
 		return;
 	}
 
+	// Refresh can reset stacks without changing them through the stacks API
+	MarkAttributeModifiersDirty(StatusEffect);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectRefreshed.Broadcast(this, StatusEffect);
+	}
+
+	if (FReplicatedStatusEffectsList* ReplicatedList = GetReplicatedStatusEffectsList(StatusEffect))
+	{
+		ReplicatedList->UpdateEntry(StatusEffect);
+	}
+}
+
+void UStatusEffectsManagerComponent::HandleStatusEffectStacksChanged(UStatusEffectBase* StatusEffect,
+                                                                     int32 NewStacks)
+{
+	MarkAttributeModifiersDirty(StatusEffect);
+
+	FReplicatedStatusEffectsList* ReplicatedList = GetReplicatedStatusEffectsList(StatusEffect);
+
+	if (!ReplicatedList)
+	{
+		return;
+	}
+
+	ReplicatedList->UpdateEntry(StatusEffect);
+}
+
+bool UStatusEffectsManagerComponent::CanReplicateStatusEffects() const
+{
+	return GetIsReplicated() && GetOwnerRole() == ROLE_Authority;
+}
+
+FReplicatedStatusEffectsList* UStatusEffectsManagerComponent::GetReplicatedStatusEffectsList(
+	const UStatusEffectBase* StatusEffect)
+{
+	if (!IsValid(StatusEffect) || StatusEffect->GetIsReplicatedProxy() || !CanReplicateStatusEffects())
+	{
+		return nullptr;
+	}
+
+	switch (StatusEffect->GetReplicationPolicy())
+	{
+	case EStatusEffectReplicationPolicy::ServerOnly:
+		break;
+
+	case EStatusEffectReplicationPolicy::OwnerOnly:
+		return &OwnerReplicatedStatusEffects;
+
+	case EStatusEffectReplicationPolicy::Everyone:
+		return &ReplicatedStatusEffects;
+	}
+
+	return nullptr;
+}
+
+void UStatusEffectsManagerComponent::HandleReplicatedStatusEffectAdded(FReplicatedStatusEffect& Entry)
+{
+	if (Entry.StatusEffect.IsValid())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Replication);
+
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	// Properties are received before the delta replicated lists, so the hash is up to date here
+	if (!IsValid(Registry) || !Registry->VerifyRemoteRegistryHash(RegistryHash))
+	{
+		return;
+	}
+
+	const TSubclassOf<UStatusEffectBase> StatusEffectClass = Registry->ResolveClass(Entry.ClassId);
+
+	if (!IsValid(StatusEffectClass))
+	{
+		return;
+	}
+
+	UStatusEffectBase* NewStatusEffect = NewObject<UStatusEffectBase>(this, StatusEffectClass);
+
+	if (!IsValid(NewStatusEffect))
+	{
+		return;
+	}
+
+	if (!NewStatusEffect->ActivateAsProxy(this, Entry.Instigator, Entry.CurrentStacks, Entry.StartTime, Entry.EndTime))
+	{
+		return;
+	}
+
+	Entry.StatusEffect = NewStatusEffect;
+	AppliedStatusEffects.Add(NewStatusEffect);
+	AddActiveClassId(NewStatusEffect);
+	AddToExclusiveGroup(NewStatusEffect);
+	AddAttributeModifiers(NewStatusEffect);
+	INC_DWORD_STAT(STAT_StatusEffects_NumActive);
+	CSV_STATUSEFFECTS_COUNT(ActiveEffects, 1);
+	INC_DWORD_STAT(STAT_StatusEffects_NumApplied);
+	CSV_STATUSEFFECTS_COUNT(Applied, 1);
+	NewStatusEffect->OnStatusEffectDeactivated.AddUniqueDynamic(
+		this, &UStatusEffectsManagerComponent::HandleStatusEffectDeactivated);
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+	OnStatusEffectApplied.Broadcast(this, NewStatusEffect, Entry.Instigator);
+}
+
+void UStatusEffectsManagerComponent::HandleReplicatedStatusEffectChanged(FReplicatedStatusEffect& Entry)
+{
+	UStatusEffectBase* StatusEffect = Entry.StatusEffect.Get();
+
+	if (!IsValid(StatusEffect))
+	{
+		// The class could be unresolved when the entry was added
+		HandleReplicatedStatusEffectAdded(Entry);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Replication);
+	StatusEffect->ApplyReplicatedState(Entry.CurrentStacks, Entry.StartTime, Entry.EndTime);
+	MarkAttributeModifiersDirty(StatusEffect);
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
 	OnStatusEffectRefreshed.Broadcast(this, StatusEffect);
 }
 
+void UStatusEffectsManagerComponent::HandleReplicatedStatusEffectRemoved(FReplicatedStatusEffect& Entry)
+{
+	UStatusEffectBase* StatusEffect = Entry.StatusEffect.Get();
+
+	if (!IsValid(StatusEffect))
+	{
+		return;
+	}
+
+	Entry.StatusEffect = nullptr;
+	StatusEffect->Deactivate(nullptr);
+}
+
 UStatusEffectBase* UStatusEffectsManagerComponent::CreateNewStatusEffect(
 	const TSubclassOf<UStatusEffectBase>& StatusEffect,
 	AActor* Instigator)
@@ -519,12 +960,344 @@ UStatusEffectBase* UStatusEffectsManagerComponent::CreateNewStatusEffect(
 		return nullptr;
 	}
 
-	AppliedStatusEffects.Add(NewStatusEffect);
-	NewStatusEffect->OnStatusEffectDeactivated.AddUniqueDynamic(
+	RegisterStatusEffect(NewStatusEffect, Instigator);
+	INC_DWORD_STAT(STAT_StatusEffects_NumApplied);
+	CSV_STATUSEFFECTS_COUNT(Applied, 1);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Broadcast);
+		OnStatusEffectApplied.Broadcast(this, NewStatusEffect, Instigator);
+	}
+
+	return NewStatusEffect;
+}
+
+void UStatusEffectsManagerComponent::HandleStatusEffectClassLoaded(TSoftClassPtr<UStatusEffectBase> StatusEffect)
+{
+	TArray<FPendingStatusEffect> LoadedStatusEffects;
+
+	for (int32 Index = 0; Index < PendingStatusEffects.Num(); ++Index)
+	{
+		if (PendingStatusEffects[Index].StatusEffect != StatusEffect)
+		{
+			continue;
+		}
+
+		LoadedStatusEffects.Add(PendingStatusEffects[Index]);
+		PendingStatusEffects.RemoveAt(Index--);
+	}
+
+	const TSubclassOf<UStatusEffectBase> StatusEffectClass = StatusEffect.Get();
+
+	if (!IsValid(StatusEffectClass))
+	{
+		UE_LOG(LogStatusEffect, Warning, TEXT("%s failed to load %s. Pending status effects discarded: %d"),
+		       *GetName(),
+		       *StatusEffect.ToString(),
+		       LoadedStatusEffects.Num());
+		return;
+	}
+
+	for (const FPendingStatusEffect& PendingStatusEffect : LoadedStatusEffects)
+	{
+		ApplyStatusEffect(StatusEffectClass, PendingStatusEffect.Instigator.Get());
+	}
+}
+
+void UStatusEffectsManagerComponent::RegisterStatusEffect(UStatusEffectBase* StatusEffect, AActor* Instigator)
+{
+	AppliedStatusEffects.Add(StatusEffect);
+	AddActiveClassId(StatusEffect);
+	AddToExclusiveGroup(StatusEffect);
+	AddAttributeModifiers(StatusEffect);
+	INC_DWORD_STAT(STAT_StatusEffects_NumActive);
+	CSV_STATUSEFFECTS_COUNT(ActiveEffects, 1);
+	StatusEffect->OnStatusEffectDeactivated.AddUniqueDynamic(
 		this, &UStatusEffectsManagerComponent::HandleStatusEffectDeactivated);
-	NewStatusEffect->OnStatusEffectRefreshed.AddUniqueDynamic(
+	StatusEffect->OnStatusEffectRefreshed.AddUniqueDynamic(
 		this, &UStatusEffectsManagerComponent::HandleStatusEffectRefreshed);
-	return NewStatusEffect;
+	StatusEffect->OnStatusEffectStacksIncreased.AddUniqueDynamic(
+		this, &UStatusEffectsManagerComponent::HandleStatusEffectStacksChanged);
+	StatusEffect->OnStatusEffectStacksDecreased.AddUniqueDynamic(
+		this, &UStatusEffectsManagerComponent::HandleStatusEffectStacksChanged);
+
+	if (FReplicatedStatusEffectsList* ReplicatedList = GetReplicatedStatusEffectsList(StatusEffect))
+	{
+		// Appended classes change the hash, so it's refreshed with every replicated class ID
+		if (UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get())
+		{
+			RegistryHash = Registry->GetRegistryHash();
+		}
+
+		ReplicatedList->AddEntry(StatusEffect, Instigator);
+	}
+}
+
+bool UStatusEffectsManagerComponent::IsBlockedByInteractionRules(const TSubclassOf<UStatusEffectBase> StatusEffect) const
+{
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!IsValid(Registry))
+	{
+		return false;
+	}
+
+	if (!Registry->IsBlockedByInteractionRules(Registry->GetClassId(StatusEffect), ActiveClassIds))
+	{
+		return false;
+	}
+
+	UE_LOG(LogStatusEffectLifecycle, Verbose, TEXT("%s application blocked by interaction rules. Target: %s"),
+	       *StatusEffect->GetName(),
+	       *GetOwner()->GetActorNameOrLabel());
+	return true;
+}
+
+void UStatusEffectsManagerComponent::CancelByInteractionRules(const UStatusEffectBase* AppliedStatusEffect,
+                                                              AActor* Instigator)
+{
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+
+	if (!IsValid(Registry))
+	{
+		return;
+	}
+
+	const TBitArray<>* CancelledClassIds = Registry->GetCancelledClassIds(AppliedStatusEffect->GetClassId());
+
+	if (!CancelledClassIds || AppliedStatusEffects.IsEmpty())
+	{
+		return;
+	}
+
+	// The applied status effect is never cancelled by its own rules
+	auto Predicate = [CancelledClassIds, AppliedStatusEffect](const UStatusEffectBase* Effect)
+	{
+		return Effect != AppliedStatusEffect
+			&& CancelledClassIds->IsValidIndex(Effect->GetClassId())
+			&& (*CancelledClassIds)[Effect->GetClassId()];
+	};
+
+	TArray<UStatusEffectBase*> StatusEffects = AppliedStatusEffects.FilterByPredicate(Predicate);
+	RemoveGivenStatusEffects(StatusEffects, Instigator);
+}
+
+bool UStatusEffectsManagerComponent::ResolveExclusiveGroup(const UStatusEffectBase* StatusEffectCDO,
+                                                            AActor* Instigator,
+                                                            UStatusEffectBase*& OutReplacedStatusEffect) const
+{
+	OutReplacedStatusEffect = nullptr;
+	const FGameplayTag ExclusiveGroup = StatusEffectCDO->GetExclusiveGroup();
+
+	if (!ExclusiveGroup.IsValid())
+	{
+		return true;
+	}
+
+	UStatusEffectBase* ActiveStatusEffect = ExclusiveGroupSlots.FindRef(ExclusiveGroup);
+
+	if (!IsValid(ActiveStatusEffect))
+	{
+		return true;
+	}
+
+	// The active member is refreshed instead of being replaced
+	if (ActiveStatusEffect->GetClass() == StatusEffectCDO->GetClass())
+	{
+		switch (StatusEffectCDO->GetEffectScope())
+		{
+		case EStatusEffectScope::PerTarget:
+			return true;
+
+		case EStatusEffectScope::PerInstigator:
+			if (ActiveStatusEffect->GetInstigatorActor() == Instigator)
+			{
+				return true;
+			}
+			break;
+
+		case EStatusEffectScope::PerInstance:
+			break;
+		}
+	}
+
+	if (ActiveStatusEffect->GetGroupPriority() > StatusEffectCDO->GetGroupPriority())
+	{
+		UE_LOG(LogStatusEffectLifecycle, Verbose, TEXT("%s application rejected. %s has a higher priority in group %s"),
+		       *StatusEffectCDO->GetClass()->GetName(),
+		       *ActiveStatusEffect->GetName(),
+		       *ExclusiveGroup.ToString());
+		return false;
+	}
+
+	OutReplacedStatusEffect = ActiveStatusEffect;
+	return true;
+}
+
+void UStatusEffectsManagerComponent::AddToExclusiveGroup(UStatusEffectBase* StatusEffect)
+{
+	if (StatusEffect->GetExclusiveGroup().IsValid())
+	{
+		ExclusiveGroupSlots.Add(StatusEffect->GetExclusiveGroup(), StatusEffect);
+	}
+}
+
+void UStatusEffectsManagerComponent::RemoveFromExclusiveGroup(const UStatusEffectBase* StatusEffect)
+{
+	const FGameplayTag ExclusiveGroup = StatusEffect->GetExclusiveGroup();
+
+	// Replicated members can be added before the replaced member is removed
+	if (ExclusiveGroup.IsValid() && ExclusiveGroupSlots.FindRef(ExclusiveGroup) == StatusEffect)
+	{
+		ExclusiveGroupSlots.Remove(ExclusiveGroup);
+	}
+}
+
+void UStatusEffectsManagerComponent::AddActiveClassId(const UStatusEffectBase* StatusEffect)
+{
+	const uint16 ClassId = StatusEffect->GetClassId();
+
+	if (ActiveClassIds.Num() <= ClassId)
+	{
+		ActiveClassIds.SetNum(ClassId + 1, false);
+	}
+
+	ActiveClassIds[ClassId] = true;
+}
+
+void UStatusEffectsManagerComponent::RemoveActiveClassId(const UStatusEffectBase* StatusEffect)
+{
+	const uint16 ClassId = StatusEffect->GetClassId();
+
+	if (!ActiveClassIds.IsValidIndex(ClassId))
+	{
+		return;
+	}
+
+	// Other instances of the class can still be active
+	auto Predicate = [ClassId](const UStatusEffectBase* Effect)
+	{
+		return Effect->GetClassId() == ClassId;
+	};
+
+	ActiveClassIds[ClassId] = AppliedStatusEffects.ContainsByPredicate(Predicate);
+}
+
+void UStatusEffectsManagerComponent::AddAttributeModifiers(UStatusEffectBase* StatusEffect)
+{
+	if (StatusEffect->GetAttributeModifiers().IsEmpty())
+	{
+		return;
+	}
+
+	for (const FStatusEffectAttributeModifier& Modifier : StatusEffect->GetAttributeModifiers())
+	{
+		if (!Modifier.Attribute.IsValid())
+		{
+			continue;
+		}
+
+		AttributeAggregates.FindOrAdd(Modifier.Attribute).StatusEffects.AddUnique(StatusEffect);
+	}
+
+	MarkAttributeModifiersDirty(StatusEffect);
+}
+
+void UStatusEffectsManagerComponent::RemoveAttributeModifiers(UStatusEffectBase* StatusEffect)
+{
+	if (StatusEffect->GetAttributeModifiers().IsEmpty())
+	{
+		return;
+	}
+
+	for (const FStatusEffectAttributeModifier& Modifier : StatusEffect->GetAttributeModifiers())
+	{
+		FAttributeAggregate* Aggregate = AttributeAggregates.Find(Modifier.Attribute);
+
+		if (!Aggregate || Aggregate->StatusEffects.Remove(StatusEffect) == 0)
+		{
+			continue;
+		}
+
+		if (Aggregate->StatusEffects.IsEmpty())
+		{
+			AttributeAggregates.Remove(Modifier.Attribute);
+		}
+		else
+		{
+			Aggregate->bIsDirty = true;
+		}
+
+		OnAttributeModifiersChanged.Broadcast(this, Modifier.Attribute);
+	}
+}
+
+void UStatusEffectsManagerComponent::MarkAttributeModifiersDirty(const UStatusEffectBase* StatusEffect)
+{
+	if (StatusEffect->GetAttributeModifiers().IsEmpty())
+	{
+		return;
+	}
+
+	// A status effect can modify the same attribute several times, but listeners are notified once
+	TArray<FGameplayTag, TInlineAllocator<4>> ChangedAttributes;
+
+	for (const FStatusEffectAttributeModifier& Modifier : StatusEffect->GetAttributeModifiers())
+	{
+		if (FAttributeAggregate* Aggregate = AttributeAggregates.Find(Modifier.Attribute))
+		{
+			Aggregate->bIsDirty = true;
+			ChangedAttributes.AddUnique(Modifier.Attribute);
+		}
+	}
+
+	for (const FGameplayTag& Attribute : ChangedAttributes)
+	{
+		OnAttributeModifiersChanged.Broadcast(this, Attribute);
+	}
+}
+
+void UStatusEffectsManagerComponent::AggregateAttributeModifiers(const FGameplayTag& Attribute,
+                                                                 FAttributeAggregate& Aggregate)
+{
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_AttributeModifiers);
+
+	Aggregate.Addition = 0.f;
+	Aggregate.Multiplier = 1.f;
+	Aggregate.bHasOverride = false;
+	Aggregate.bIsDirty = false;
+
+	for (const UStatusEffectBase* StatusEffect : Aggregate.StatusEffects)
+	{
+		const int32 Stacks = StatusEffect->GetIsStackable() ? FMath::Max(StatusEffect->GetCurrentStacks(), 1) : 1;
+
+		for (const FStatusEffectAttributeModifier& Modifier : StatusEffect->GetAttributeModifiers())
+		{
+			if (Modifier.Attribute != Attribute)
+			{
+				continue;
+			}
+
+			const int32 ModifierStacks = Modifier.bScaleByStacks ? Stacks : 1;
+
+			switch (Modifier.Operation)
+			{
+			case EStatusEffectModifierOperation::Add:
+				Aggregate.Addition += Modifier.Magnitude * ModifierStacks;
+				break;
+
+			case EStatusEffectModifierOperation::Multiply:
+				Aggregate.Multiplier *= FMath::Pow(Modifier.Magnitude, ModifierStacks);
+				break;
+
+			case EStatusEffectModifierOperation::Override:
+				// The latest applied override wins
+				Aggregate.OverrideValue = Modifier.Magnitude;
+				Aggregate.bHasOverride = true;
+				break;
+			}
+		}
+	}
 }
 
 void UStatusEffectsManagerComponent::RefreshGivenStatusEffects(TArray<UStatusEffectBase*>& StatusEffects)
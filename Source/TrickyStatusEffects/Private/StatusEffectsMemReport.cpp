@@ -0,0 +1,199 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsMemReport.h"
+
+#include "StatusEffectBase.h"
+#include "StatusEffectsManagerComponent.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/OutputDevice.h"
+#include "UObject/UObjectIterator.h"
+
+namespace StatusEffectsMemReport
+{
+	static const TCHAR* CommandName = TEXT("StatusEffects.MemReport");
+
+	struct FClassUsage
+	{
+		const UClass* Class = nullptr;
+
+		int32 NumStatusEffects = 0;
+
+		FStatusEffectsMemoryUsage Usage;
+	};
+
+	struct FManagerUsage
+	{
+		const UStatusEffectsManagerComponent* Manager = nullptr;
+
+		int32 NumStatusEffects = 0;
+
+		FStatusEffectsMemoryUsage ManagerUsage;
+
+		FStatusEffectsMemoryUsage StatusEffectsUsage;
+
+		SIZE_T GetTotalBytes() const { return ManagerUsage.GetTotalBytes() + StatusEffectsUsage.GetTotalBytes(); }
+	};
+
+	static double ToKilobytes(const SIZE_T Bytes)
+	{
+		return static_cast<double>(Bytes) / 1024.0;
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice MemReportCommand(
+		CommandName,
+		TEXT("Prints memory used by status effects per class and per manager, including delegates and array slack. ")
+		TEXT("Usage: StatusEffects.MemReport [MaxManagers]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FStatusEffectsMemReport::Run));
+}
+
+void FStatusEffectsMemReport::Initialize()
+{
+	if (!GConfig)
+	{
+		return;
+	}
+
+	GConfig->AddUniqueToSection(TEXT("MemReportCommands"),
+	                            TEXT("Cmd"),
+	                            StatusEffectsMemReport::CommandName,
+	                            GEngineIni);
+}
+
+void FStatusEffectsMemReport::Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	using namespace StatusEffectsMemReport;
+
+	const int32 MaxManagers = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 20;
+
+	TMap<const UClass*, FClassUsage> ClassUsages;
+	TArray<FManagerUsage> ManagerUsages;
+	FStatusEffectsMemoryUsage TotalManagersUsage;
+	FStatusEffectsMemoryUsage TotalStatusEffectsUsage;
+	int32 NumStatusEffects = 0;
+
+	for (TObjectIterator<UStatusEffectsManagerComponent> It; It; ++It)
+	{
+		const UStatusEffectsManagerComponent* Manager = *It;
+
+		if (!IsValid(Manager) || (World && Manager->GetWorld() != World))
+		{
+			continue;
+		}
+
+		FManagerUsage& ManagerUsage = ManagerUsages.AddDefaulted_GetRef();
+		ManagerUsage.Manager = Manager;
+		Manager->AccumulateMemoryUsage(ManagerUsage.ManagerUsage);
+
+		TArray<UStatusEffectBase*> StatusEffects;
+		Manager->GetAllStatusEffects(StatusEffects);
+
+		for (const UStatusEffectBase* StatusEffect : StatusEffects)
+		{
+			if (!IsValid(StatusEffect))
+			{
+				continue;
+			}
+
+			FStatusEffectsMemoryUsage StatusEffectUsage;
+			StatusEffect->AccumulateMemoryUsage(StatusEffectUsage);
+
+			FClassUsage& ClassUsage = ClassUsages.FindOrAdd(StatusEffect->GetClass());
+			ClassUsage.Class = StatusEffect->GetClass();
+			ClassUsage.NumStatusEffects++;
+			ClassUsage.Usage += StatusEffectUsage;
+
+			ManagerUsage.NumStatusEffects++;
+			ManagerUsage.StatusEffectsUsage += StatusEffectUsage;
+		}
+
+		NumStatusEffects += ManagerUsage.NumStatusEffects;
+		TotalManagersUsage += ManagerUsage.ManagerUsage;
+		TotalStatusEffectsUsage += ManagerUsage.StatusEffectsUsage;
+	}
+
+	Ar.Logf(TEXT("Status effects memory: %d managers, %d status effects, %.2f KB total"),
+	        ManagerUsages.Num(),
+	        NumStatusEffects,
+	        ToKilobytes(TotalManagersUsage.GetTotalBytes() + TotalStatusEffectsUsage.GetTotalBytes()));
+	Ar.Logf(TEXT("%-16s %12s %12s %12s %12s"),
+	        TEXT(""),
+	        TEXT("Objects KB"),
+	        TEXT("Delegates KB"),
+	        TEXT("Arrays KB"),
+	        TEXT("Slack KB"));
+
+	auto LogUsage = [&Ar](const TCHAR* Name, const FStatusEffectsMemoryUsage& Usage)
+	{
+		Ar.Logf(TEXT("%-16s %12.2f %12.2f %12.2f %12.2f"),
+		        Name,
+		        ToKilobytes(Usage.ObjectBytes),
+		        ToKilobytes(Usage.DelegateBytes),
+		        ToKilobytes(Usage.ContainerBytes),
+		        ToKilobytes(Usage.SlackBytes));
+	};
+
+	LogUsage(TEXT("Managers"), TotalManagersUsage);
+	LogUsage(TEXT("Status effects"), TotalStatusEffectsUsage);
+
+	TArray<FClassUsage> SortedClassUsages;
+	ClassUsages.GenerateValueArray(SortedClassUsages);
+	SortedClassUsages.Sort([](const FClassUsage& A, const FClassUsage& B)
+	{
+		return A.Usage.GetTotalBytes() > B.Usage.GetTotalBytes();
+	});
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("%-48s %8s %12s %12s %12s %12s"),
+	        TEXT("Class"),
+	        TEXT("Count"),
+	        TEXT("Total KB"),
+	        TEXT("Bytes/Effect"),
+	        TEXT("Delegates KB"),
+	        TEXT("Slack KB"));
+
+	for (const FClassUsage& ClassUsage : SortedClassUsages)
+	{
+		Ar.Logf(TEXT("%-48s %8d %12.2f %12llu %12.2f %12.2f"),
+		        *ClassUsage.Class->GetName(),
+		        ClassUsage.NumStatusEffects,
+		        ToKilobytes(ClassUsage.Usage.GetTotalBytes()),
+		        static_cast<uint64>(ClassUsage.Usage.GetTotalBytes() / ClassUsage.NumStatusEffects),
+		        ToKilobytes(ClassUsage.Usage.DelegateBytes),
+		        ToKilobytes(ClassUsage.Usage.SlackBytes));
+	}
+
+	if (MaxManagers == 0)
+	{
+		return;
+	}
+
+	ManagerUsages.Sort([](const FManagerUsage& A, const FManagerUsage& B)
+	{
+		return A.GetTotalBytes() > B.GetTotalBytes();
+	});
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Top %d managers"), FMath::Min(MaxManagers, ManagerUsages.Num()));
+	Ar.Logf(TEXT("%-48s %8s %12s %12s %12s"),
+	        TEXT("Owner"),
+	        TEXT("Effects"),
+	        TEXT("Manager KB"),
+	        TEXT("Effects KB"),
+	        TEXT("Slack KB"));
+
+	for (int32 Index = 0; Index < FMath::Min(MaxManagers, ManagerUsages.Num()); ++Index)
+	{
+		const FManagerUsage& ManagerUsage = ManagerUsages[Index];
+		const AActor* Owner = ManagerUsage.Manager->GetOwner();
+
+		Ar.Logf(TEXT("%-48s %8d %12.2f %12.2f %12.2f"),
+		        IsValid(Owner) ? *Owner->GetName() : *ManagerUsage.Manager->GetName(),
+		        ManagerUsage.NumStatusEffects,
+		        ToKilobytes(ManagerUsage.ManagerUsage.GetTotalBytes()),
+		        ToKilobytes(ManagerUsage.StatusEffectsUsage.GetTotalBytes()),
+		        ToKilobytes(ManagerUsage.ManagerUsage.SlackBytes + ManagerUsage.StatusEffectsUsage.SlackBytes));
+	}
+}
@@ -0,0 +1,19 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Reports memory of status effects aggregated per class and per manager with the StatusEffects.MemReport command.
+ * The command is included into memreport.
+ */
+struct FStatusEffectsMemReport
+{
+	/**
+	 * Adds the report command to MemReportCommands of the engine config
+	 */
+	static void Initialize();
+
+	static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+};
@@ -0,0 +1,734 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsRegistry.h"
+
+#include "StatusEffectBase.h"
+#include "StatusEffectsSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Engine.h"
+#include "Interfaces/IPluginManager.h"
+#include "Interfaces/IProjectManager.h"
+#include "ProjectDescriptor.h"
+#include "Misc/PackageName.h"
+
+namespace StatusEffectsRegistry
+{
+	// Names of searchable UStatusEffectBase properties exported to asset registry tags
+	static const FName EffectTypeTag = TEXT("EffectType");
+	static const FName EffectScopeTag = TEXT("EffectScope");
+	static const FName ReplicationPolicyTag = TEXT("ReplicationPolicy");
+	static const FName EffectTagsTag = TEXT("EffectTags");
+	static const FName TickEffectTag = TEXT("bTickEffect");
+	static const FName IsInfiniteTag = TEXT("bIsInfinite");
+	static const FName DurationTag = TEXT("Duration");
+	static const FName NativeParentClassTag = TEXT("NativeParentClass");
+
+	static const FName EventNames[] = {
+		TEXT("CanBeActivated"),
+		TEXT("ActivateEffect"),
+		TEXT("TickEffect"),
+		TEXT("RefreshEffect"),
+		TEXT("DeactivateEffect"),
+		TEXT("HandleStacksIncreased"),
+		TEXT("HandleStacksDecreased")
+	};
+
+	template <typename TEnum>
+	static void ReadEnumTag(const FAssetData& AssetData, const FName TagName, TEnum& OutValue)
+	{
+		FString Value;
+
+		if (!AssetData.GetTagValue(TagName, Value))
+		{
+			return;
+		}
+
+		const int64 EnumValue = StaticEnum<TEnum>()->GetValueByNameString(Value);
+
+		if (EnumValue != INDEX_NONE)
+		{
+			OutValue = static_cast<TEnum>(EnumValue);
+		}
+	}
+
+	static bool ReadBoolTag(const FAssetData& AssetData, const FName TagName, const bool bDefaultValue)
+	{
+		FString Value;
+		return AssetData.GetTagValue(TagName, Value) ? Value.ToBool() : bDefaultValue;
+	}
+
+	static bool HasAnyCommonBits(const TBitArray<>& A, const TBitArray<>& B)
+	{
+		// Bits past the end of a bit array are always cleared, so comparing whole words is safe
+		const int32 NumWords = FMath::DivideAndRoundUp(FMath::Min(A.Num(), B.Num()), NumBitsPerDWORD);
+		const uint32* WordsA = A.GetData();
+		const uint32* WordsB = B.GetData();
+
+		for (int32 Index = 0; Index < NumWords; ++Index)
+		{
+			if (WordsA[Index] & WordsB[Index])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+void UStatusEffectsRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+}
+
+void UStatusEffectsRegistry::Deinitialize()
+{
+	for (const TPair<FName, TSharedPtr<FStreamableHandle>>& PreloadHandle : PreloadHandles)
+	{
+		if (PreloadHandle.Value.IsValid())
+		{
+			PreloadHandle.Value->ReleaseHandle();
+		}
+	}
+
+	PreloadHandles.Empty();
+
+	Super::Deinitialize();
+}
+
+UStatusEffectsRegistry* UStatusEffectsRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UStatusEffectsRegistry>() : nullptr;
+}
+
+uint16 UStatusEffectsRegistry::GetClassId(const UClass* StatusEffectClass)
+{
+	if (!IsValid(StatusEffectClass) || !StatusEffectClass->IsChildOf(UStatusEffectBase::StaticClass()))
+	{
+		return InvalidClassId;
+	}
+
+	UStatusEffectBase* DefaultObject = Cast<UStatusEffectBase>(StatusEffectClass->GetDefaultObject(false));
+
+	if (DefaultObject && DefaultObject->ClassId != InvalidClassId)
+	{
+		return DefaultObject->ClassId;
+	}
+
+	EnsureBuilt();
+
+	const FTopLevelAssetPath ClassPath = StatusEffectClass->GetClassPathName();
+	uint16 ClassId = InvalidClassId;
+
+	if (const uint16* RegisteredClassId = ClassIds.Find(ClassPath))
+	{
+		ClassId = *RegisteredClassId;
+	}
+	else
+	{
+		// Appending keeps IDs which were already handed out valid. The registry hash changes with it,
+		// so a remote process which doesn't know the class detects the mismatch
+		UE_LOG(LogStatusEffect, Verbose, TEXT("%s is appended to the status effects registry"), *ClassPath.ToString());
+		ClassId = RegisterClassPath(ClassPath);
+	}
+
+	// IDs are never reassigned, so the cached ID stays valid. Recompiled Blueprints get a new default object
+	if (DefaultObject)
+	{
+		DefaultObject->ClassId = ClassId;
+	}
+
+	return ClassId;
+}
+
+FTopLevelAssetPath UStatusEffectsRegistry::GetClassPath(const uint16 ClassId) const
+{
+	if (ClassId == InvalidClassId || !Entries.IsValidIndex(ClassId))
+	{
+		return FTopLevelAssetPath();
+	}
+
+	return Entries[ClassId].StatusEffectClass.ToSoftObjectPath().GetAssetPath();
+}
+
+TSubclassOf<UStatusEffectBase> UStatusEffectsRegistry::ResolveClass(const uint16 ClassId)
+{
+	EnsureBuilt();
+
+	if (ClassId == InvalidClassId || !Entries.IsValidIndex(ClassId))
+	{
+		return nullptr;
+	}
+
+	UClass* StatusEffectClass = ResolvedClasses[ClassId].Get();
+
+	if (!IsValid(StatusEffectClass))
+	{
+		StatusEffectClass = Entries[ClassId].StatusEffectClass.LoadSynchronous();
+		ResolvedClasses[ClassId] = StatusEffectClass;
+
+		if (IsValid(StatusEffectClass))
+		{
+			FillEntryFromClass(Entries[ClassId], StatusEffectClass);
+		}
+	}
+
+	return StatusEffectClass;
+}
+
+const FStatusEffectCatalogEntry* UStatusEffectsRegistry::GetCatalogEntry(const uint16 ClassId) const
+{
+	if (ClassId == InvalidClassId || !Entries.IsValidIndex(ClassId))
+	{
+		return nullptr;
+	}
+
+	return &Entries[ClassId];
+}
+
+const FStatusEffectCatalogEntry* UStatusEffectsRegistry::GetCatalogEntry(const UClass* StatusEffectClass)
+{
+	const uint16 ClassId = GetClassId(StatusEffectClass);
+
+	if (ClassId == InvalidClassId)
+	{
+		return nullptr;
+	}
+
+	FStatusEffectCatalogEntry& Entry = Entries[ClassId];
+	bool bIsEntryOutdated = !Entry.bAreEventOverridesKnown;
+
+#if WITH_EDITOR
+	// Recompiled Blueprints replace their class, so overrides could have changed
+	bIsEntryOutdated |= ResolvedClasses[ClassId].Get() != StatusEffectClass;
+#endif
+
+	if (bIsEntryOutdated)
+	{
+		FillEntryFromClass(Entry, StatusEffectClass);
+		ResolvedClasses[ClassId] = const_cast<UClass*>(StatusEffectClass);
+	}
+
+	return &Entry;
+}
+
+void UStatusEffectsRegistry::GetStatusEffectClassesOfType(const EStatusEffectType StatusEffectType,
+                                                          TArray<TSoftClassPtr<UStatusEffectBase>>& OutStatusEffects)
+{
+	EnsureBuilt();
+
+	for (int32 ClassId = InvalidClassId + 1; ClassId < Entries.Num(); ++ClassId)
+	{
+		if (Entries[ClassId].EffectType == StatusEffectType)
+		{
+			OutStatusEffects.Add(Entries[ClassId].StatusEffectClass);
+		}
+	}
+}
+
+void UStatusEffectsRegistry::GetStatusEffectClassesWithAnyTags(const FGameplayTagContainer& EffectTags,
+                                                               TArray<TSoftClassPtr<UStatusEffectBase>>&
+                                                               OutStatusEffects)
+{
+	EnsureBuilt();
+
+	for (int32 ClassId = InvalidClassId + 1; ClassId < Entries.Num(); ++ClassId)
+	{
+		if (Entries[ClassId].EffectTags.HasAny(EffectTags))
+		{
+			OutStatusEffects.Add(Entries[ClassId].StatusEffectClass);
+		}
+	}
+}
+
+void UStatusEffectsRegistry::RequestAsyncLoad(const TSoftClassPtr<UStatusEffectBase>& StatusEffect,
+                                              const FStreamableDelegate& OnLoaded)
+{
+	if (StatusEffect.IsNull())
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	const TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(
+		StatusEffect.ToSoftObjectPath(),
+		OnLoaded,
+		FStreamableManager::AsyncLoadHighPriority);
+
+	if (!Handle.IsValid())
+	{
+		OnLoaded.ExecuteIfBound();
+	}
+}
+
+void UStatusEffectsRegistry::PreloadStatusEffectClasses(const FName PreloadGroup,
+                                                        const TArray<TSoftClassPtr<UStatusEffectBase>>& StatusEffects,
+                                                        const FOnStatusEffectsPreloadedDynamicSignature& OnPreloaded)
+{
+	TArray<FSoftObjectPath> ClassPaths;
+	ClassPaths.Reserve(StatusEffects.Num());
+
+	for (const TSoftClassPtr<UStatusEffectBase>& StatusEffect : StatusEffects)
+	{
+		if (!StatusEffect.IsNull())
+		{
+			ClassPaths.AddUnique(StatusEffect.ToSoftObjectPath());
+		}
+	}
+
+	// Keep the previous handle alive until the new one takes over to avoid unloading shared classes
+	const TSharedPtr<FStreamableHandle> PreviousHandle = PreloadHandles.FindRef(PreloadGroup);
+
+	if (ClassPaths.IsEmpty())
+	{
+		PreloadHandles.Remove(PreloadGroup);
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [OnPreloaded]()
+	{
+		OnPreloaded.ExecuteIfBound();
+	});
+
+	const TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(
+		ClassPaths,
+		OnLoaded,
+		FStreamableManager::DefaultAsyncLoadPriority);
+	PreloadHandles.Add(PreloadGroup, Handle);
+
+	if (PreviousHandle.IsValid())
+	{
+		PreviousHandle->ReleaseHandle();
+	}
+}
+
+void UStatusEffectsRegistry::ReleasePreloadedStatusEffectClasses(const FName PreloadGroup)
+{
+	TSharedPtr<FStreamableHandle> Handle;
+
+	if (!PreloadHandles.RemoveAndCopyValue(PreloadGroup, Handle) || !Handle.IsValid())
+	{
+		return;
+	}
+
+	Handle->ReleaseHandle();
+}
+
+bool UStatusEffectsRegistry::IsPreloadGroupLoaded(const FName PreloadGroup) const
+{
+	const TSharedPtr<FStreamableHandle>* Handle = PreloadHandles.Find(PreloadGroup);
+	return Handle && Handle->IsValid() && (*Handle)->HasLoadCompleted();
+}
+
+bool UStatusEffectsRegistry::IsBlockedByInteractionRules(const uint16 ClassId, const TBitArray<>& ActiveClassIds)
+{
+	EnsureInteractionRulesCompiled();
+
+	if (!BlockedByClassIds.IsValidIndex(ClassId) || BlockedByClassIds[ClassId].Num() == 0)
+	{
+		return false;
+	}
+
+	return StatusEffectsRegistry::HasAnyCommonBits(BlockedByClassIds[ClassId], ActiveClassIds);
+}
+
+const TBitArray<>* UStatusEffectsRegistry::GetCancelledClassIds(const uint16 ClassId)
+{
+	EnsureInteractionRulesCompiled();
+
+	if (!CancelledClassIds.IsValidIndex(ClassId) || CancelledClassIds[ClassId].Num() == 0)
+	{
+		return nullptr;
+	}
+
+	return &CancelledClassIds[ClassId];
+}
+
+uint32 UStatusEffectsRegistry::GetRegistryHash()
+{
+	EnsureBuilt();
+	return RegistryHash;
+}
+
+bool UStatusEffectsRegistry::VerifyRemoteRegistryHash(const uint32 RemoteHash)
+{
+	if (GetRegistryHash() == RemoteHash)
+	{
+		return true;
+	}
+
+	if (!bHasReportedHashMismatch)
+	{
+		bHasReportedHashMismatch = true;
+		UE_LOG(LogStatusEffect, Error,
+		       TEXT("Status effects registry hash %08X doesn't match the server hash %08X. Replicated status effects "
+		            "are ignored. The server and clients must run the same content and runtime modules"),
+		       RegistryHash,
+		       RemoteHash);
+		ensureMsgf(false, TEXT("Status effects registry mismatch"));
+	}
+
+	return false;
+}
+
+void UStatusEffectsRegistry::Build()
+{
+	// Classes found after a partial scan would be appended out of order, so IDs wait for the whole asset registry
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).
+		Get();
+
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.WaitForCompletion();
+	}
+
+	TArray<FTopLevelAssetPath> GatheredClassPaths;
+	GatherClassPaths(GatheredClassPaths);
+
+	Entries.Reset(GatheredClassPaths.Num() + 1);
+	ResolvedClasses.Reset(GatheredClassPaths.Num() + 1);
+	ClassIds.Reset();
+	RegistryHash = 0;
+
+	Entries.AddDefaulted();
+	ResolvedClasses.Add(nullptr);
+
+	for (const FTopLevelAssetPath& ClassPath : GatheredClassPaths)
+	{
+		RegisterClassPath(ClassPath);
+	}
+
+	bIsBuilt = true;
+	bAreInteractionRulesCompiled = false;
+	UE_LOG(LogStatusEffect, Log, TEXT("Status effects registry built. Classes: %d. Hash: %08X"),
+	       GetNumClasses(),
+	       RegistryHash);
+}
+
+void UStatusEffectsRegistry::EnsureInteractionRulesCompiled()
+{
+	if (bAreInteractionRulesCompiled)
+	{
+		return;
+	}
+
+	EnsureBuilt();
+	bAreInteractionRulesCompiled = true;
+
+	BlockedByClassIds.Reset();
+	CancelledClassIds.Reset();
+	BlockedByClassIds.SetNum(Entries.Num());
+	CancelledClassIds.SetNum(Entries.Num());
+
+	const UStatusEffectsSettings* Settings = GetDefault<UStatusEffectsSettings>();
+	TArray<uint16> SourceClassIds;
+	TArray<uint16> TargetClassIds;
+
+	for (const FStatusEffectInteractionRule& Rule : Settings->InteractionRules)
+	{
+		SourceClassIds.Reset();
+		TargetClassIds.Reset();
+		GetMatchingClassIds(Rule.SourceClass, Rule.SourceTags, SourceClassIds);
+		GetMatchingClassIds(Rule.TargetClass, Rule.TargetTags, TargetClassIds);
+
+		// Blocking is checked for the applied target, cancelling for the applied source
+		const bool bIsBlock = Rule.Interaction == EStatusEffectInteraction::Block;
+		TArray<TBitArray<>>& Rows = bIsBlock ? BlockedByClassIds : CancelledClassIds;
+		const TArray<uint16>& RowClassIds = bIsBlock ? TargetClassIds : SourceClassIds;
+		const TArray<uint16>& ColumnClassIds = bIsBlock ? SourceClassIds : TargetClassIds;
+
+		for (const uint16 RowClassId : RowClassIds)
+		{
+			TBitArray<>& Row = Rows[RowClassId];
+
+			if (Row.Num() == 0)
+			{
+				Row.Init(false, Entries.Num());
+			}
+
+			for (const uint16 ColumnClassId : ColumnClassIds)
+			{
+				Row[ColumnClassId] = true;
+			}
+		}
+	}
+
+	UE_LOG(LogStatusEffect, Log, TEXT("Status effect interaction rules compiled. Rules: %d"),
+	       Settings->InteractionRules.Num());
+}
+
+void UStatusEffectsRegistry::GetMatchingClassIds(const TSoftClassPtr<UStatusEffectBase>& StatusEffectClass,
+                                                 const FGameplayTagContainer& EffectTags,
+                                                 TArray<uint16>& OutClassIds) const
+{
+	if (!StatusEffectClass.IsNull())
+	{
+		if (const uint16* ClassId = ClassIds.Find(StatusEffectClass.ToSoftObjectPath().GetAssetPath()))
+		{
+			OutClassIds.AddUnique(*ClassId);
+		}
+	}
+
+	if (EffectTags.IsEmpty())
+	{
+		return;
+	}
+
+	for (int32 ClassId = InvalidClassId + 1; ClassId < Entries.Num(); ++ClassId)
+	{
+		if (Entries[ClassId].EffectTags.HasAny(EffectTags))
+		{
+			OutClassIds.AddUnique(static_cast<uint16>(ClassId));
+		}
+	}
+}
+
+void UStatusEffectsRegistry::EnsureBuilt()
+{
+	if (bIsBuilt)
+	{
+		return;
+	}
+
+	Build();
+}
+
+uint16 UStatusEffectsRegistry::RegisterClassPath(const FTopLevelAssetPath& ClassPath)
+{
+	if (Entries.Num() > MAX_uint16)
+	{
+		UE_LOG(LogStatusEffect, Error, TEXT("Can't register %s. Status effects registry is full"),
+		       *ClassPath.ToString());
+		return InvalidClassId;
+	}
+
+	const uint16 ClassId = static_cast<uint16>(Entries.Num());
+	FStatusEffectCatalogEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.ClassId = ClassId;
+	Entry.StatusEffectClass = TSoftClassPtr<UStatusEffectBase>(FSoftObjectPath(ClassPath));
+	ResolvedClasses.Add(nullptr);
+	ClassIds.Add(ClassPath, ClassId);
+	RegistryHash = FCrc::StrCrc32(*ClassPath.ToString(), RegistryHash);
+	bAreInteractionRulesCompiled = false;
+
+	if (const UClass* LoadedClass = FindObject<UClass>(ClassPath))
+	{
+		FillEntryFromClass(Entry, LoadedClass);
+		return ClassId;
+	}
+
+	// Blueprint assets are named after their generated classes without the _C suffix
+	FString AssetName = ClassPath.GetAssetName().ToString();
+	AssetName.RemoveFromEnd(TEXT("_C"));
+	const FSoftObjectPath AssetPath(FTopLevelAssetPath(ClassPath.GetPackageName(), FName(*AssetName)));
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+		TEXT("AssetRegistry")).Get();
+	const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(AssetPath);
+
+	if (AssetData.IsValid())
+	{
+		FillEntryFromAssetData(Entry, AssetData);
+	}
+
+	return ClassId;
+}
+
+void UStatusEffectsRegistry::GatherClassPaths(TArray<FTopLevelAssetPath>& OutClassPaths)
+{
+	TSet<FTopLevelAssetPath> UniqueClassPaths;
+
+	TArray<UClass*> LoadedClasses;
+	GetDerivedClasses(UStatusEffectBase::StaticClass(), LoadedClasses, true);
+	LoadedClasses.Add(UStatusEffectBase::StaticClass());
+
+	for (const UClass* LoadedClass : LoadedClasses)
+	{
+		if (!LoadedClass->HasAnyClassFlags(CLASS_Native) || !IsSharedNativeClass(LoadedClass))
+		{
+			continue;
+		}
+
+		UniqueClassPaths.Add(LoadedClass->GetClassPathName());
+	}
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(
+		TEXT("AssetRegistry")).Get();
+	TSet<FTopLevelAssetPath> DerivedClassPaths;
+	AssetRegistry.GetDerivedClassNames({UStatusEffectBase::StaticClass()->GetClassPathName()},
+	                                   {},
+	                                   DerivedClassPaths);
+
+	for (const FTopLevelAssetPath& DerivedClassPath : DerivedClassPaths)
+	{
+		if (IsTransientClassName(DerivedClassPath.GetAssetName().ToString()))
+		{
+			continue;
+		}
+
+		UniqueClassPaths.Add(DerivedClassPath);
+	}
+
+	OutClassPaths = UniqueClassPaths.Array();
+
+	auto Predicate = [](const FTopLevelAssetPath& A, const FTopLevelAssetPath& B)
+	{
+		return A.ToString().Compare(B.ToString(), ESearchCase::CaseSensitive) < 0;
+	};
+
+	OutClassPaths.Sort(Predicate);
+}
+
+bool UStatusEffectsRegistry::IsTransientClassName(const FString& ClassName)
+{
+	return ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_"));
+}
+
+bool UStatusEffectsRegistry::IsSharedNativeClass(const UClass* StatusEffectClass)
+{
+	// Native classes live in /Script/<ModuleName> packages
+	const FName ModuleName = FPackageName::GetShortFName(StatusEffectClass->GetOutermost()->GetFName());
+
+	auto Predicate = [ModuleName](const FModuleDescriptor& Module)
+	{
+		return Module.Name == ModuleName;
+	};
+
+	const FModuleDescriptor* ModuleDescriptor = nullptr;
+
+	for (const TSharedRef<IPlugin>& Plugin : IPluginManager::Get().GetEnabledPluginsWithCode())
+	{
+		ModuleDescriptor = Plugin->GetDescriptor().Modules.FindByPredicate(Predicate);
+
+		if (ModuleDescriptor)
+		{
+			break;
+		}
+	}
+
+	const FProjectDescriptor* Project = IProjectManager::Get().GetCurrentProject();
+
+	if (!ModuleDescriptor && Project)
+	{
+		ModuleDescriptor = Project->Modules.FindByPredicate(Predicate);
+	}
+
+	// Engine modules have no descriptors here and are built into every target
+	if (!ModuleDescriptor)
+	{
+		return true;
+	}
+
+	// Editor, developer, cooked only, client only and server only modules are missing from some targets
+	switch (ModuleDescriptor->Type)
+	{
+	case EHostType::Runtime:
+	case EHostType::RuntimeNoCommandlet:
+	case EHostType::RuntimeAndProgram:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void UStatusEffectsRegistry::FillEntryFromClass(FStatusEffectCatalogEntry& Entry, const UClass* StatusEffectClass)
+{
+	const UStatusEffectBase* StatusEffectCDO = StatusEffectClass->GetDefaultObject<UStatusEffectBase>();
+
+	if (!IsValid(StatusEffectCDO))
+	{
+		return;
+	}
+
+	Entry.EffectType = StatusEffectCDO->GetEffectType();
+	Entry.EffectScope = StatusEffectCDO->GetEffectScope();
+	Entry.ReplicationPolicy = StatusEffectCDO->GetReplicationPolicy();
+	Entry.EffectTags = StatusEffectCDO->GetEffectTags();
+	Entry.bCanEverTick = StatusEffectCDO->GetCanEverTick();
+	Entry.EventOverrides = CalculateEventOverrides(StatusEffectClass);
+	Entry.bAreEventOverridesKnown = true;
+}
+
+void UStatusEffectsRegistry::FillEntryFromAssetData(FStatusEffectCatalogEntry& Entry, const FAssetData& AssetData)
+{
+	using namespace StatusEffectsRegistry;
+
+	// Values missing in tags fall back to defaults of the native parent class
+	bool bTickEffect = false;
+	bool bIsInfinite = true;
+	float Duration = 0.f;
+	FString NativeParentClassPath;
+
+	if (AssetData.GetTagValue(NativeParentClassTag, NativeParentClassPath))
+	{
+		const FSoftObjectPath NativeParentPath(FPackageName::ExportTextPathToObjectPath(NativeParentClassPath));
+		const UClass* NativeParentClass = Cast<UClass>(NativeParentPath.ResolveObject());
+
+		if (IsValid(NativeParentClass) && NativeParentClass->IsChildOf(UStatusEffectBase::StaticClass()))
+		{
+			const UStatusEffectBase* NativeParentCDO = NativeParentClass->GetDefaultObject<UStatusEffectBase>();
+			Entry.EffectType = NativeParentCDO->GetEffectType();
+			Entry.EffectScope = NativeParentCDO->GetEffectScope();
+			Entry.ReplicationPolicy = NativeParentCDO->GetReplicationPolicy();
+			Entry.EffectTags = NativeParentCDO->GetEffectTags();
+			bIsInfinite = NativeParentCDO->GetIsInfinite();
+			Duration = NativeParentCDO->GetDuration();
+			bTickEffect = NativeParentCDO->GetTickEffect();
+		}
+	}
+
+	ReadEnumTag(AssetData, EffectTypeTag, Entry.EffectType);
+	ReadEnumTag(AssetData, EffectScopeTag, Entry.EffectScope);
+	ReadEnumTag(AssetData, ReplicationPolicyTag, Entry.ReplicationPolicy);
+
+	FString Value;
+
+	if (AssetData.GetTagValue(EffectTagsTag, Value))
+	{
+		Entry.EffectTags.FromExportString(Value);
+	}
+
+	if (AssetData.GetTagValue(DurationTag, Value))
+	{
+		Duration = FCString::Atof(*Value);
+	}
+
+	bTickEffect = ReadBoolTag(AssetData, TickEffectTag, bTickEffect);
+	bIsInfinite = ReadBoolTag(AssetData, IsInfiniteTag, bIsInfinite);
+	Entry.bCanEverTick = bTickEffect || !bIsInfinite && Duration > 0.f;
+}
+
+EStatusEffectEventOverrides UStatusEffectsRegistry::CalculateEventOverrides(const UClass* StatusEffectClass)
+{
+	using namespace StatusEffectsRegistry;
+
+	EStatusEffectEventOverrides EventOverrides = EStatusEffectEventOverrides::None;
+
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(EventNames); ++Index)
+	{
+		const UFunction* Function = StatusEffectClass->FindFunctionByName(EventNames[Index]);
+
+		// Blueprint overrides are owned by the Blueprint class, native events by UStatusEffectBase
+		if (Function && Function->GetOuterUClass() != UStatusEffectBase::StaticClass())
+		{
+			EventOverrides |= static_cast<EStatusEffectEventOverrides>(1 << Index);
+		}
+	}
+
+	const UClass* NativeClass = StatusEffectClass;
+
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+
+	if (NativeClass != UStatusEffectBase::StaticClass())
+	{
+		EventOverrides |= EStatusEffectEventOverrides::NativeImplementation;
+	}
+
+	return EventOverrides;
+}
@@ -0,0 +1,110 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsReplication.h"
+
+#include "StatusEffectBase.h"
+#include "StatusEffectsManagerComponent.h"
+
+void FReplicatedStatusEffect::PreReplicatedRemove(const FReplicatedStatusEffectsList& InArraySerializer)
+{
+	if (!IsValid(InArraySerializer.OwningManager))
+	{
+		return;
+	}
+
+	InArraySerializer.OwningManager->HandleReplicatedStatusEffectRemoved(*this);
+}
+
+void FReplicatedStatusEffect::PostReplicatedAdd(const FReplicatedStatusEffectsList& InArraySerializer)
+{
+	if (!IsValid(InArraySerializer.OwningManager))
+	{
+		return;
+	}
+
+	InArraySerializer.OwningManager->HandleReplicatedStatusEffectAdded(*this);
+}
+
+void FReplicatedStatusEffect::PostReplicatedChange(const FReplicatedStatusEffectsList& InArraySerializer)
+{
+	if (!IsValid(InArraySerializer.OwningManager))
+	{
+		return;
+	}
+
+	InArraySerializer.OwningManager->HandleReplicatedStatusEffectChanged(*this);
+}
+
+void FReplicatedStatusEffectsList::AddEntry(UStatusEffectBase* StatusEffect, AActor* Instigator)
+{
+	if (!IsValid(StatusEffect))
+	{
+		return;
+	}
+
+	FReplicatedStatusEffect& NewEntry = Items.AddDefaulted_GetRef();
+	NewEntry.ClassId = StatusEffect->GetClassId();
+	NewEntry.Instigator = Instigator;
+	NewEntry.CurrentStacks = StatusEffect->GetCurrentStacks();
+	NewEntry.StartTime = StatusEffect->GetTimerStartTime();
+	NewEntry.EndTime = StatusEffect->GetTimerEndTime();
+	NewEntry.StatusEffect = StatusEffect;
+	MarkItemDirty(NewEntry);
+}
+
+bool FReplicatedStatusEffectsList::UpdateEntry(const UStatusEffectBase* StatusEffect)
+{
+	const int32 Index = FindEntryIndex(StatusEffect);
+
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FReplicatedStatusEffect& Entry = Items[Index];
+
+	const bool bIsUpToDate = Entry.CurrentStacks == StatusEffect->GetCurrentStacks()
+		&& Entry.StartTime == StatusEffect->GetTimerStartTime()
+		&& Entry.EndTime == StatusEffect->GetTimerEndTime();
+
+	if (bIsUpToDate)
+	{
+		return true;
+	}
+
+	Entry.CurrentStacks = StatusEffect->GetCurrentStacks();
+	Entry.StartTime = StatusEffect->GetTimerStartTime();
+	Entry.EndTime = StatusEffect->GetTimerEndTime();
+	MarkItemDirty(Entry);
+	return true;
+}
+
+bool FReplicatedStatusEffectsList::RemoveEntry(const UStatusEffectBase* StatusEffect)
+{
+	const int32 Index = FindEntryIndex(StatusEffect);
+
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Items.RemoveAtSwap(Index);
+	MarkArrayDirty();
+	return true;
+}
+
+int32 FReplicatedStatusEffectsList::FindEntryIndex(const UStatusEffectBase* StatusEffect) const
+{
+	if (!StatusEffect)
+	{
+		return INDEX_NONE;
+	}
+
+	auto Predicate = [StatusEffect](const FReplicatedStatusEffect& Entry)
+	{
+		return Entry.StatusEffect.Get(true) == StatusEffect;
+	};
+
+	return Items.IndexOfByPredicate(Predicate);
+}
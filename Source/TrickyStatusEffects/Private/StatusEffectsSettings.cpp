@@ -0,0 +1,23 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsSettings.h"
+
+#include "StatusEffectsRegistry.h"
+
+UStatusEffectsSettings::UStatusEffectsSettings()
+{
+	CategoryName = TEXT("Plugins");
+}
+
+#if WITH_EDITOR
+void UStatusEffectsSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get())
+	{
+		Registry->InvalidateInteractionRules();
+	}
+}
+#endif
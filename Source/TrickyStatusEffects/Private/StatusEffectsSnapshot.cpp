@@ -0,0 +1,133 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsSnapshot.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+void FStatusEffectsSnapshot::Encode(TArray<uint8>& OutData)
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+	Serialize(Writer);
+}
+
+bool FStatusEffectsSnapshot::Decode(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+	return Serialize(Reader);
+}
+
+bool FStatusEffectsSnapshot::Serialize(FArchive& Ar)
+{
+	uint32 SavedMagic = Magic;
+	Ar << SavedMagic;
+
+	if (Ar.IsLoading() && SavedMagic != Magic)
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	uint16 Version = static_cast<uint16>(EVersion::Latest);
+	Ar << Version;
+
+	if (Ar.IsLoading() && (Version == 0 || Version > static_cast<uint16>(EVersion::Latest)))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	// Each class path is written once and referenced by its index in the table from records.
+	// Class IDs can't be used as keys because all unregistered classes share the invalid ID
+	TArray<FString> ClassPaths;
+	TArray<uint16> ClassIndices;
+
+	if (Ar.IsSaving())
+	{
+		TMap<FString, uint16> ClassIndexByPath;
+		ClassIndices.Reserve(Records.Num());
+
+		for (const FStatusEffectSnapshotRecord& Record : Records)
+		{
+			const uint16* ClassIndex = ClassIndexByPath.Find(Record.ClassPath);
+
+			if (!ClassIndex)
+			{
+				ClassIndex = &ClassIndexByPath.Add(Record.ClassPath, static_cast<uint16>(ClassPaths.Add(Record.ClassPath)));
+			}
+
+			ClassIndices.Add(*ClassIndex);
+		}
+	}
+
+	int32 NumClasses = ClassPaths.Num();
+	Ar << NumClasses;
+
+	if (NumClasses < 0 || NumClasses > MAX_uint16 || (Ar.IsLoading() && NumClasses > Ar.TotalSize()))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	if (Ar.IsLoading())
+	{
+		ClassPaths.SetNum(NumClasses);
+	}
+
+	for (FString& ClassPath : ClassPaths)
+	{
+		Ar << ClassPath;
+
+		if (Ar.IsError())
+		{
+			return false;
+		}
+	}
+
+	int32 NumRecords = Records.Num();
+	Ar << NumRecords;
+
+	if (NumRecords < 0 || (Ar.IsLoading() && NumRecords > Ar.TotalSize()))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	if (Ar.IsLoading())
+	{
+		Records.SetNum(NumRecords);
+	}
+
+	for (int32 Index = 0; Index < Records.Num(); ++Index)
+	{
+		FStatusEffectSnapshotRecord& Record = Records[Index];
+		uint16 ClassIndex = Ar.IsSaving() ? ClassIndices[Index] : 0;
+		Ar << ClassIndex;
+		Ar << Record.InstigatorPath;
+		Ar << Record.RemainingTime;
+		Ar << Record.TickPhase;
+		Ar << Record.Stacks;
+		Ar << Record.StackRemainingTimes;
+		Ar << Record.Payload;
+
+		if (Ar.IsError())
+		{
+			return false;
+		}
+
+		if (Ar.IsLoading())
+		{
+			if (!ClassPaths.IsValidIndex(ClassIndex))
+			{
+				Ar.SetError();
+				return false;
+			}
+
+			Record.ClassPath = ClassPaths[ClassIndex];
+		}
+	}
+
+	return !Ar.IsError();
+}
@@ -0,0 +1,49 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsStats.h"
+
+DEFINE_STAT(STAT_StatusEffects_Apply);
+DEFINE_STAT(STAT_StatusEffects_Refresh);
+DEFINE_STAT(STAT_StatusEffects_Tick);
+DEFINE_STAT(STAT_StatusEffects_Duration);
+DEFINE_STAT(STAT_StatusEffects_Deactivate);
+DEFINE_STAT(STAT_StatusEffects_Broadcast);
+DEFINE_STAT(STAT_StatusEffects_Replication);
+DEFINE_STAT(STAT_StatusEffects_Periodic);
+DEFINE_STAT(STAT_StatusEffects_AttributeModifiers);
+DEFINE_STAT(STAT_StatusEffects_Requests);
+
+DEFINE_STAT(STAT_StatusEffects_NumManagers);
+DEFINE_STAT(STAT_StatusEffects_NumActive);
+DEFINE_STAT(STAT_StatusEffects_NumApplied);
+DEFINE_STAT(STAT_StatusEffects_NumDeactivated);
+DEFINE_STAT(STAT_StatusEffects_NumDeferredTicks);
+DEFINE_STAT(STAT_StatusEffects_NumRequests);
+
+TStatId StatusEffectsStats::GetClassStatId(const UClass* StatusEffectClass)
+{
+#if STATS
+	if (!StatusEffectClass)
+	{
+		return GET_STATID(STAT_StatusEffects_Tick);
+	}
+
+	// Tickables are ticked on the game thread only
+	check(IsInGameThread());
+
+	static TMap<FName, TStatId> ClassStatIds;
+	const FName ClassName = StatusEffectClass->GetFName();
+
+	if (const TStatId* StatId = ClassStatIds.Find(ClassName))
+	{
+		return *StatId;
+	}
+
+	const TStatId StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_StatusEffects>(ClassName);
+	ClassStatIds.Add(ClassName, StatId);
+	return StatId;
+#else
+	return TStatId();
+#endif
+}
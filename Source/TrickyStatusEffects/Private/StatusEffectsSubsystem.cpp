@@ -0,0 +1,544 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsSubsystem.h"
+
+#include "PeriodicStatusEffect.h"
+#include "StatusEffectAttributeReceiver.h"
+#include "StatusEffectsCsvProfiler.h"
+#include "StatusEffectsLibrary.h"
+#include "StatusEffectsManagerComponent.h"
+#include "StatusEffectsRegistry.h"
+#include "StatusEffectsStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace StatusEffectsSubsystem
+{
+	static float TickBudgetMs = 0.f;
+
+	static FAutoConsoleVariableRef TickBudgetVariable(
+		TEXT("StatusEffects.TickBudgetMs"),
+		TickBudgetMs,
+		TEXT("The time in milliseconds status effect ticks can take per frame. ")
+		TEXT("Ticks which exceed the budget roll over to the next frame. Critical status effects ignore the budget. ")
+		TEXT("0 disables the budget."));
+}
+
+FStatusEffectRequestTarget::FStatusEffectRequestTarget(AActor* InActor)
+	: Actor(InActor)
+{
+}
+
+FStatusEffectRequestTarget::FStatusEffectRequestTarget(UStatusEffectsManagerComponent* InManager)
+	: Manager(InManager)
+{
+}
+
+void UStatusEffectsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this,
+		&UStatusEffectsSubsystem::HandleWorldPostActorTick);
+}
+
+void UStatusEffectsSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	for (TArray<TWeakObjectPtr<UStatusEffectBase>>& Queue : TickQueues)
+	{
+		Queue.Empty();
+	}
+
+	AddPendingPeriodicKernels();
+
+	for (const FPeriodicKernel& Kernel : PeriodicKernels)
+	{
+		if (Kernel.StatusEffect)
+		{
+			Kernel.StatusEffect->KernelIndex = INDEX_NONE;
+			Kernel.StatusEffect->KernelSubsystem = nullptr;
+		}
+	}
+
+	PeriodicKernels.Empty();
+
+	Requests.Empty();
+	NumQueuedRequests = 0;
+
+	Super::Deinitialize();
+}
+
+bool UStatusEffectsSubsystem::IsTickBudgetEnabled()
+{
+	return StatusEffectsSubsystem::TickBudgetMs > 0.f;
+}
+
+void UStatusEffectsSubsystem::QueueTick(UStatusEffectBase* StatusEffect)
+{
+	if (!IsValid(StatusEffect))
+	{
+		return;
+	}
+
+	const uint8 Priority = static_cast<uint8>(StatusEffect->GetTickPriority());
+
+	if (!ensure(Priority < UE_ARRAY_COUNT(TickQueues)))
+	{
+		return;
+	}
+
+	TickQueues[Priority].Emplace(StatusEffect);
+}
+
+int32 UStatusEffectsSubsystem::GetNumQueuedTicks(const EStatusEffectTickPriority Priority) const
+{
+	const uint8 Index = static_cast<uint8>(Priority);
+	return Index < UE_ARRAY_COUNT(TickQueues) ? TickQueues[Index].Num() : 0;
+}
+
+void UStatusEffectsSubsystem::RegisterPeriodicStatusEffect(UPeriodicStatusEffect* StatusEffect,
+                                                           IStatusEffectAttributeReceiver* Receiver)
+{
+	if (!IsValid(StatusEffect) || !Receiver || StatusEffect->KernelIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	FPeriodicKernel Kernel;
+	Kernel.StatusEffect = StatusEffect;
+	Kernel.Receiver = Receiver;
+	Kernel.Attribute = StatusEffect->GetAttribute();
+	Kernel.Period = FMath::Max(StatusEffect->GetPeriod(), UE_KINDA_SMALL_NUMBER);
+	Kernel.TimeToNextPeriod = StatusEffect->bApplyOnActivation ? 0.f : Kernel.Period;
+
+	if (StatusEffect->RestoredTimeToNextPeriod >= 0.f)
+	{
+		Kernel.TimeToNextPeriod = StatusEffect->RestoredTimeToNextPeriod;
+		StatusEffect->RestoredTimeToNextPeriod = -1.f;
+	}
+
+	StatusEffect->KernelSubsystem = this;
+
+	// Receivers can apply periodic status effects while kernels are processed, which must not reallocate them
+	if (bIsProcessingPeriodicKernels)
+	{
+		PendingPeriodicKernels.Add(Kernel);
+		StatusEffect->KernelIndex = PendingKernelIndex;
+		return;
+	}
+
+	StatusEffect->KernelIndex = PeriodicKernels.Add(Kernel);
+}
+
+void UStatusEffectsSubsystem::UnregisterPeriodicStatusEffect(UPeriodicStatusEffect* StatusEffect)
+{
+	if (!StatusEffect)
+	{
+		return;
+	}
+
+	if (StatusEffect->KernelIndex == PendingKernelIndex)
+	{
+		PendingPeriodicKernels.RemoveAll([StatusEffect](const FPeriodicKernel& Kernel)
+		{
+			return Kernel.StatusEffect == StatusEffect;
+		});
+
+		StatusEffect->KernelIndex = INDEX_NONE;
+		StatusEffect->KernelSubsystem = nullptr;
+		return;
+	}
+
+	if (!PeriodicKernels.IsValidIndex(StatusEffect->KernelIndex))
+	{
+		return;
+	}
+
+	const int32 Index = StatusEffect->KernelIndex;
+
+	if (!ensure(PeriodicKernels[Index].StatusEffect == StatusEffect))
+	{
+		return;
+	}
+
+	StatusEffect->KernelIndex = INDEX_NONE;
+	StatusEffect->KernelSubsystem = nullptr;
+
+	if (bIsProcessingPeriodicKernels)
+	{
+		PeriodicKernels[Index].StatusEffect = nullptr;
+		PeriodicKernels[Index].Receiver.Reset();
+		bHasUnregisteredPeriodicKernels = true;
+		return;
+	}
+
+	PeriodicKernels.RemoveAtSwap(Index);
+
+	if (PeriodicKernels.IsValidIndex(Index) && PeriodicKernels[Index].StatusEffect)
+	{
+		PeriodicKernels[Index].StatusEffect->KernelIndex = Index;
+	}
+}
+
+float UStatusEffectsSubsystem::GetTimeToNextPeriod(const UPeriodicStatusEffect* StatusEffect) const
+{
+	if (StatusEffect && StatusEffect->KernelIndex == PendingKernelIndex)
+	{
+		const FPeriodicKernel* Kernel = PendingPeriodicKernels.FindByPredicate(
+			[StatusEffect](const FPeriodicKernel& PendingKernel)
+			{
+				return PendingKernel.StatusEffect == StatusEffect;
+			});
+
+		return Kernel ? FMath::Max(Kernel->TimeToNextPeriod, 0.f) : -1.f;
+	}
+
+	if (!StatusEffect || !PeriodicKernels.IsValidIndex(StatusEffect->KernelIndex))
+	{
+		return -1.f;
+	}
+
+	return FMath::Max(PeriodicKernels[StatusEffect->KernelIndex].TimeToNextPeriod, 0.f);
+}
+
+void UStatusEffectsSubsystem::QueueApplyStatusEffect(const FStatusEffectRequestTarget& Target,
+                                                     const TSubclassOf<UStatusEffectBase> StatusEffect,
+                                                     AActor* Instigator)
+{
+	QueueRequest({ERequestType::Apply, Target, StatusEffect, Instigator});
+}
+
+void UStatusEffectsSubsystem::QueueRefreshStatusEffect(const FStatusEffectRequestTarget& Target,
+                                                       const TSubclassOf<UStatusEffectBase> StatusEffect)
+{
+	QueueRequest({ERequestType::Refresh, Target, StatusEffect, nullptr});
+}
+
+void UStatusEffectsSubsystem::QueueRemoveStatusEffect(const FStatusEffectRequestTarget& Target,
+                                                      const TSubclassOf<UStatusEffectBase> StatusEffect,
+                                                      AActor* Remover)
+{
+	QueueRequest({ERequestType::Remove, Target, StatusEffect, Remover});
+}
+
+void UStatusEffectsSubsystem::QueueRequest(FRequest&& Request)
+{
+	if (!Request.StatusEffect)
+	{
+		return;
+	}
+
+	Request.ProducerId = FPlatformTLS::GetCurrentThreadId();
+	Requests.Enqueue(MoveTemp(Request));
+	NumQueuedRequests.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool UStatusEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UStatusEffectsSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	ProcessRequests();
+
+	if (!World->IsPaused())
+	{
+		ProcessPeriodicKernels(DeltaSeconds);
+	}
+
+	ProcessTickQueues();
+}
+
+void UStatusEffectsSubsystem::ProcessRequests()
+{
+	if (Requests.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Requests);
+
+	struct FResolvedRequest
+	{
+		const FRequest* Request = nullptr;
+
+		UStatusEffectsManagerComponent* Manager = nullptr;
+
+		/**
+		 * Path of the target actor. Unlike names, paths are unique across levels
+		 */
+		FString OwnerPath;
+
+		uint16 ClassId = 0;
+
+		/**
+		 * Path of the status effect class. Set only for unregistered classes, which share the invalid ID
+		 */
+		FString ClassPath;
+
+		FString InstigatorPath;
+
+		/**
+		 * Number of earlier requests of the same producer for the same target
+		 */
+		int32 Sequence = 0;
+	};
+
+	// Requests queued while the batch is processed wait for the next frame
+	TArray<FRequest> Batch;
+	Batch.Reserve(NumQueuedRequests.load(std::memory_order_relaxed));
+	FRequest Request;
+
+	while (Requests.Dequeue(Request))
+	{
+		Batch.Add(MoveTemp(Request));
+	}
+
+	NumQueuedRequests.fetch_sub(Batch.Num(), std::memory_order_relaxed);
+	INC_DWORD_STAT_BY(STAT_StatusEffects_NumRequests, Batch.Num());
+
+	UStatusEffectsRegistry* Registry = UStatusEffectsRegistry::Get();
+	TArray<FResolvedRequest> ResolvedRequests;
+	ResolvedRequests.Reserve(Batch.Num());
+
+	// The queue keeps the order of each producer, so sequences count requests in the order they were queued
+	using FSequenceKey = TTuple<const UStatusEffectsManagerComponent*, uint32>;
+	TMap<FSequenceKey, int32> Sequences;
+
+	for (const FRequest& BatchRequest : Batch)
+	{
+		UStatusEffectsManagerComponent* Manager = BatchRequest.Target.Manager.Get();
+
+		if (!Manager)
+		{
+			Manager = UStatusEffectsLibrary::GetStatusEffectsManager(BatchRequest.Target.Actor.Get());
+		}
+
+		if (!IsValid(Manager) || !IsValid(Manager->GetOwner()) || Manager->GetWorld() != GetWorld())
+		{
+			continue;
+		}
+
+		FResolvedRequest& ResolvedRequest = ResolvedRequests.AddDefaulted_GetRef();
+		ResolvedRequest.Request = &BatchRequest;
+		ResolvedRequest.Manager = Manager;
+		ResolvedRequest.OwnerPath = Manager->GetOwner()->GetPathName();
+		ResolvedRequest.ClassId = IsValid(Registry) ? Registry->GetClassId(BatchRequest.StatusEffect) : 0;
+
+		if (ResolvedRequest.ClassId == 0)
+		{
+			ResolvedRequest.ClassPath = BatchRequest.StatusEffect->GetPathName();
+		}
+
+		if (const AActor* Instigator = BatchRequest.Instigator.Get())
+		{
+			ResolvedRequest.InstigatorPath = Instigator->GetPathName();
+		}
+
+		ResolvedRequest.Sequence = Sequences.FindOrAdd(FSequenceKey(Manager, BatchRequest.ProducerId))++;
+	}
+
+	// Paths of actors, sequences, registry IDs and class paths are the same for the same input,
+	// unlike the order of producer threads. Sequences keep the order of each producer for a target,
+	// e.g. a removal and a following apply of the same class. Requests equal by all keys have the same effect
+	auto Predicate = [](const FResolvedRequest& A, const FResolvedRequest& B)
+	{
+		const int32 OwnerOrder = A.OwnerPath.Compare(B.OwnerPath, ESearchCase::CaseSensitive);
+
+		if (OwnerOrder != 0)
+		{
+			return OwnerOrder < 0;
+		}
+
+		if (A.Sequence != B.Sequence)
+		{
+			return A.Sequence < B.Sequence;
+		}
+
+		if (A.ClassId != B.ClassId)
+		{
+			return A.ClassId < B.ClassId;
+		}
+
+		const int32 ClassPathOrder = A.ClassPath.Compare(B.ClassPath);
+
+		if (ClassPathOrder != 0)
+		{
+			return ClassPathOrder < 0;
+		}
+
+		const int32 InstigatorOrder = A.InstigatorPath.Compare(B.InstigatorPath, ESearchCase::CaseSensitive);
+
+		if (InstigatorOrder != 0)
+		{
+			return InstigatorOrder < 0;
+		}
+
+		return A.Request->Type < B.Request->Type;
+	};
+
+	ResolvedRequests.StableSort(Predicate);
+
+	for (const FResolvedRequest& ResolvedRequest : ResolvedRequests)
+	{
+		// Status effects of the batch can destroy other targets
+		if (!IsValid(ResolvedRequest.Manager))
+		{
+			continue;
+		}
+
+		const FRequest& BatchRequest = *ResolvedRequest.Request;
+
+		switch (BatchRequest.Type)
+		{
+		case ERequestType::Apply:
+			ResolvedRequest.Manager->ApplyStatusEffect(BatchRequest.StatusEffect, BatchRequest.Instigator.Get());
+			break;
+
+		case ERequestType::Refresh:
+			ResolvedRequest.Manager->RefreshAllStatusEffectsOfClass(BatchRequest.StatusEffect);
+			break;
+
+		case ERequestType::Remove:
+			ResolvedRequest.Manager->RemoveStatusEffect(BatchRequest.StatusEffect, BatchRequest.Instigator.Get());
+			break;
+		}
+	}
+}
+
+void UStatusEffectsSubsystem::ProcessTickQueues()
+{
+	// Queues are drained even if the budget was disabled while ticks were waiting
+	const uint64 BudgetCycles = IsTickBudgetEnabled()
+		                            ? static_cast<uint64>(StatusEffectsSubsystem::TickBudgetMs / 1000.0 /
+			                            FPlatformTime::GetSecondsPerCycle64())
+		                            : MAX_uint64;
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	int32 NumDeferredTicks = 0;
+
+	for (TArray<TWeakObjectPtr<UStatusEffectBase>>& Queue : TickQueues)
+	{
+		int32 NumProcessed = 0;
+
+		// Queued status effects can queue others while ticking, so the number of ticks is checked on each iteration
+		for (; NumProcessed < Queue.Num(); ++NumProcessed)
+		{
+			if (FPlatformTime::Cycles64() - StartCycles >= BudgetCycles)
+			{
+				break;
+			}
+
+			UStatusEffectBase* StatusEffect = Queue[NumProcessed].Get();
+
+			if (!IsValid(StatusEffect))
+			{
+				continue;
+			}
+
+			const float DeltaTime = StatusEffect->PendingTickDeltaTime;
+			StatusEffect->PendingTickDeltaTime = 0.f;
+			StatusEffect->bIsTickQueued = false;
+
+			CSV_STATUSEFFECTS_SCOPE(Tick, StatusEffect->GetClassId());
+			StatusEffect->ProcessTick(DeltaTime);
+		}
+
+		NumDeferredTicks += Queue.Num() - NumProcessed;
+		Queue.RemoveAt(0, NumProcessed);
+	}
+
+	INC_DWORD_STAT_BY(STAT_StatusEffects_NumDeferredTicks, NumDeferredTicks);
+}
+
+void UStatusEffectsSubsystem::ProcessPeriodicKernels(const float DeltaTime)
+{
+	if (PeriodicKernels.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Periodic);
+	CSV_STATUSEFFECTS_SCOPE(Tick);
+
+	bIsProcessingPeriodicKernels = true;
+
+	// Kernels registered by receivers during the loop are added after it and start on the next frame
+	const int32 NumKernels = PeriodicKernels.Num();
+
+	for (int32 Index = 0; Index < NumKernels; ++Index)
+	{
+		PeriodicKernels[Index].TimeToNextPeriod -= DeltaTime;
+
+		// Receivers can remove status effects and register new ones, so the kernel is accessed by index
+		while (PeriodicKernels[Index].StatusEffect && PeriodicKernels[Index].TimeToNextPeriod <= 0.f)
+		{
+			FPeriodicKernel& Kernel = PeriodicKernels[Index];
+			Kernel.TimeToNextPeriod += Kernel.Period;
+
+			// Nothing passed to the receiver may reference the kernel, as the receiver can unregister it
+			UPeriodicStatusEffect* StatusEffect = Kernel.StatusEffect;
+			IStatusEffectAttributeReceiver* Receiver = Kernel.Receiver.Get();
+
+			if (!Receiver || !IsValid(StatusEffect))
+			{
+				UnregisterPeriodicStatusEffect(StatusEffect);
+				break;
+			}
+
+			const FGameplayTag Attribute = Kernel.Attribute;
+			const float Magnitude = StatusEffect->CalculateMagnitude();
+			Receiver->ApplyStatusEffectAttributeDelta(Attribute, Magnitude, StatusEffect);
+		}
+	}
+
+	bIsProcessingPeriodicKernels = false;
+
+	if (bHasUnregisteredPeriodicKernels)
+	{
+		RemoveUnregisteredPeriodicKernels();
+	}
+
+	AddPendingPeriodicKernels();
+}
+
+void UStatusEffectsSubsystem::RemoveUnregisteredPeriodicKernels()
+{
+	// Kernels after the index are already compacted, so a swapped kernel is always registered
+	for (int32 Index = PeriodicKernels.Num() - 1; Index >= 0; --Index)
+	{
+		if (PeriodicKernels[Index].StatusEffect)
+		{
+			continue;
+		}
+
+		PeriodicKernels.RemoveAtSwap(Index);
+
+		if (PeriodicKernels.IsValidIndex(Index))
+		{
+			PeriodicKernels[Index].StatusEffect->KernelIndex = Index;
+		}
+	}
+
+	bHasUnregisteredPeriodicKernels = false;
+}
+
+void UStatusEffectsSubsystem::AddPendingPeriodicKernels()
+{
+	for (const FPeriodicKernel& Kernel : PendingPeriodicKernels)
+	{
+		Kernel.StatusEffect->KernelIndex = PeriodicKernels.Add(Kernel);
+	}
+
+	PendingPeriodicKernels.Reset();
+}
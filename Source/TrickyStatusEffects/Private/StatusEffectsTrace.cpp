@@ -0,0 +1,132 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsTrace.h"
+
+#if STATUSEFFECTS_TRACE_ENABLED
+
+#include "StatusEffectBase.h"
+#include "GameFramework/Actor.h"
+
+UE_TRACE_CHANNEL_DEFINE(StatusEffectsChannel)
+
+UE_TRACE_EVENT_BEGIN(StatusEffects, Activated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EffectId)
+	UE_TRACE_EVENT_FIELD(uint16, ClassId)
+	UE_TRACE_EVENT_FIELD(uint32, TargetId)
+	UE_TRACE_EVENT_FIELD(uint32, InstigatorId)
+	UE_TRACE_EVENT_FIELD(float, Duration)
+	UE_TRACE_EVENT_FIELD(int32, Stacks)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(StatusEffects, Refreshed)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EffectId)
+	UE_TRACE_EVENT_FIELD(float, RemainingTime)
+	UE_TRACE_EVENT_FIELD(int32, Stacks)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(StatusEffects, StacksChanged)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EffectId)
+	UE_TRACE_EVENT_FIELD(int32, Delta)
+	UE_TRACE_EVENT_FIELD(int32, Stacks)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(StatusEffects, Ticked)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EffectId)
+	UE_TRACE_EVENT_FIELD(float, DeltaTime)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(StatusEffects, Deactivated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EffectId)
+	UE_TRACE_EVENT_FIELD(uint32, DeactivatorId)
+	UE_TRACE_EVENT_FIELD(float, RemainingTime)
+	UE_TRACE_EVENT_FIELD(int32, Stacks)
+UE_TRACE_EVENT_END()
+
+namespace StatusEffectsTrace
+{
+	uint32 GetObjectId(const UObject* Object)
+	{
+		return Object ? Object->GetUniqueID() : 0;
+	}
+}
+
+void FStatusEffectsTrace::OutputActivated(const UStatusEffectBase* StatusEffect)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(StatusEffectsChannel) || !StatusEffect)
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(StatusEffects, Activated, StatusEffectsChannel)
+		<< Activated.Cycle(FPlatformTime::Cycles64())
+		<< Activated.EffectId(StatusEffect->GetUniqueID())
+		<< Activated.ClassId(StatusEffect->GetClassId())
+		<< Activated.TargetId(StatusEffectsTrace::GetObjectId(StatusEffect->GetTargetActor()))
+		<< Activated.InstigatorId(StatusEffectsTrace::GetObjectId(StatusEffect->GetInstigatorActor()))
+		<< Activated.Duration(StatusEffect->GetRemainingTime())
+		<< Activated.Stacks(StatusEffect->GetCurrentStacks());
+}
+
+void FStatusEffectsTrace::OutputRefreshed(const UStatusEffectBase* StatusEffect)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(StatusEffectsChannel) || !StatusEffect)
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(StatusEffects, Refreshed, StatusEffectsChannel)
+		<< Refreshed.Cycle(FPlatformTime::Cycles64())
+		<< Refreshed.EffectId(StatusEffect->GetUniqueID())
+		<< Refreshed.RemainingTime(StatusEffect->GetRemainingTime())
+		<< Refreshed.Stacks(StatusEffect->GetCurrentStacks());
+}
+
+void FStatusEffectsTrace::OutputStacksChanged(const UStatusEffectBase* StatusEffect, const int32 Delta)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(StatusEffectsChannel) || !StatusEffect)
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(StatusEffects, StacksChanged, StatusEffectsChannel)
+		<< StacksChanged.Cycle(FPlatformTime::Cycles64())
+		<< StacksChanged.EffectId(StatusEffect->GetUniqueID())
+		<< StacksChanged.Delta(Delta)
+		<< StacksChanged.Stacks(StatusEffect->GetCurrentStacks());
+}
+
+void FStatusEffectsTrace::OutputTicked(const UStatusEffectBase* StatusEffect, const float DeltaTime)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(StatusEffectsChannel) || !StatusEffect)
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(StatusEffects, Ticked, StatusEffectsChannel)
+		<< Ticked.Cycle(FPlatformTime::Cycles64())
+		<< Ticked.EffectId(StatusEffect->GetUniqueID())
+		<< Ticked.DeltaTime(DeltaTime);
+}
+
+void FStatusEffectsTrace::OutputDeactivated(const UStatusEffectBase* StatusEffect, const AActor* Deactivator)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(StatusEffectsChannel) || !StatusEffect)
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(StatusEffects, Deactivated, StatusEffectsChannel)
+		<< Deactivated.Cycle(FPlatformTime::Cycles64())
+		<< Deactivated.EffectId(StatusEffect->GetUniqueID())
+		<< Deactivated.DeactivatorId(StatusEffectsTrace::GetObjectId(Deactivator))
+		<< Deactivated.RemainingTime(StatusEffect->GetRemainingTime())
+		<< Deactivated.Stacks(StatusEffect->GetCurrentStacks());
+}
+
+#endif
@@ -2,17 +2,28 @@
 
 #include "TrickyStatusEffects.h"
 
+#include "StatusEffectsCsvProfiler.h"
+#include "StatusEffectsMemReport.h"
+
 #define LOCTEXT_NAMESPACE "FTrickyStatusEffectsModule"
 
 void FTrickyStatusEffectsModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FStatusEffectsMemReport::Initialize();
+
+#if CSV_PROFILER
+	FStatusEffectsCsvProfiler::Initialize();
+#endif
 }
 
 void FTrickyStatusEffectsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+#if CSV_PROFILER
+	FStatusEffectsCsvProfiler::Shutdown();
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
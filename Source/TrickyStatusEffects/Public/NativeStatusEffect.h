@@ -0,0 +1,208 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StatusEffectBase.h"
+#include "StatusEffectsStats.h"
+#include "StatusEffectsTrace.h"
+#include <type_traits>
+
+/**
+ * Handlers of a native status effect class called by UStatusEffectBase instead of its BlueprintNativeEvents
+ */
+struct FStatusEffectNativeDispatch
+{
+	UClass* (*GetStatusEffectClass)() = nullptr;
+
+	/**
+	 * Replaces UStatusEffectBase::Tick. Processes the duration timer and the tick
+	 */
+	void (*Tick)(UStatusEffectBase* StatusEffect, float DeltaTime) = nullptr;
+
+	void (*TickEffect)(UStatusEffectBase* StatusEffect, float DeltaTime) = nullptr;
+
+	void (*RefreshEffect)(UStatusEffectBase* StatusEffect) = nullptr;
+
+	void (*HandleStacksIncreased)(UStatusEffectBase* StatusEffect, int32 Amount) = nullptr;
+
+	void (*HandleStacksDecreased)(UStatusEffectBase* StatusEffect, int32 Amount) = nullptr;
+
+	bool bCanEverTick = false;
+};
+
+/**
+ * Compile time configuration of a native status effect. Derive FConfig of a status effect from it to override values
+ */
+struct FStatusEffectNativeConfig
+{
+	static constexpr bool bTickEffect = false;
+
+	static constexpr float TickInterval = 0.f;
+
+	static constexpr bool bIsInfinite = true;
+
+	static constexpr float Duration = 0.f;
+};
+
+/**
+ * Base for status effects written in C++ which statically dispatches their handlers.
+ * TickEffect, RefreshEffect, HandleStacksIncreased and HandleStacksDecreased are replaced by non-virtual
+ * NativeTickEffect, NativeRefreshEffect, NativeHandleStacksIncreased and NativeHandleStacksDecreased of the derived
+ * class, which are called without ProcessEvent, virtual calls or _Implementation thunks.
+ * Handlers which aren't declared by the derived class aren't called at all. Declare them public.
+ *
+ * Tick and duration settings are taken from FConfig of the derived class at compile time, so branches of disabled
+ * features compile away. They're also written into the matching properties to keep queries and the catalog correct.
+ *
+ * Blueprint subclasses of the derived class use regular dispatch, as their settings can differ from FConfig.
+ *
+ * UCLASS(NotBlueprintable)
+ * class UBleedingStatusEffect : public UStatusEffectBase, public TStatusEffect<UBleedingStatusEffect>
+ * {
+ *     GENERATED_BODY()
+ *
+ * public:
+ *     struct FConfig : FStatusEffectNativeConfig
+ *     {
+ *         static constexpr bool bTickEffect = true;
+ *         static constexpr float TickInterval = 0.5f;
+ *         static constexpr bool bIsInfinite = false;
+ *         static constexpr float Duration = 5.f;
+ *     };
+ *
+ *     void NativeTickEffect(float DeltaTime);
+ * };
+ */
+template <typename Derived>
+class TStatusEffect
+{
+public:
+	using FConfig = FStatusEffectNativeConfig;
+
+	void NativeTickEffect(float DeltaTime)
+	{
+	}
+
+	void NativeRefreshEffect()
+	{
+	}
+
+	void NativeHandleStacksIncreased(int32 Amount)
+	{
+	}
+
+	void NativeHandleStacksDecreased(int32 Amount)
+	{
+	}
+
+	static const FStatusEffectNativeDispatch& GetNativeDispatch()
+	{
+		static const FStatusEffectNativeDispatch Dispatch = MakeNativeDispatch();
+		return Dispatch;
+	}
+
+protected:
+	TStatusEffect()
+	{
+		using Config = typename Derived::FConfig;
+
+		// The base is already constructed, so its properties can be initialized before the derived constructor runs
+		UStatusEffectBase* StatusEffect = static_cast<Derived*>(this);
+		StatusEffect->bTickEffect = Config::bTickEffect;
+		StatusEffect->TickInterval = Config::TickInterval;
+		StatusEffect->bIsInfinite = Config::bIsInfinite;
+		StatusEffect->Duration = Config::Duration;
+		StatusEffect->NativeDispatch = &GetNativeDispatch();
+	}
+
+private:
+	// The derived class is incomplete when the template is instantiated, so its config is accessed only in functions
+	static constexpr bool HasDurationTimer()
+	{
+		using Config = typename Derived::FConfig;
+		return !Config::bIsInfinite && Config::Duration > 0.f;
+	}
+
+	static FStatusEffectNativeDispatch MakeNativeDispatch()
+	{
+		using Config = typename Derived::FConfig;
+
+		FStatusEffectNativeDispatch Dispatch;
+		Dispatch.GetStatusEffectClass = &Derived::StaticClass;
+		Dispatch.Tick = &TickStatusEffect;
+		Dispatch.bCanEverTick = Config::bTickEffect || HasDurationTimer();
+
+		if constexpr (!std::is_same_v<decltype(&Derived::NativeTickEffect), decltype(&TStatusEffect::NativeTickEffect)>)
+		{
+			Dispatch.TickEffect = [](UStatusEffectBase* StatusEffect, const float DeltaTime)
+			{
+				static_cast<Derived*>(StatusEffect)->NativeTickEffect(DeltaTime);
+			};
+		}
+
+		if constexpr (!std::is_same_v<decltype(&Derived::NativeRefreshEffect), decltype(&TStatusEffect::NativeRefreshEffect)>)
+		{
+			Dispatch.RefreshEffect = [](UStatusEffectBase* StatusEffect)
+			{
+				static_cast<Derived*>(StatusEffect)->NativeRefreshEffect();
+			};
+		}
+
+		if constexpr (!std::is_same_v<decltype(&Derived::NativeHandleStacksIncreased),
+		                              decltype(&TStatusEffect::NativeHandleStacksIncreased)>)
+		{
+			Dispatch.HandleStacksIncreased = [](UStatusEffectBase* StatusEffect, const int32 Amount)
+			{
+				static_cast<Derived*>(StatusEffect)->NativeHandleStacksIncreased(Amount);
+			};
+		}
+
+		if constexpr (!std::is_same_v<decltype(&Derived::NativeHandleStacksDecreased),
+		                              decltype(&TStatusEffect::NativeHandleStacksDecreased)>)
+		{
+			Dispatch.HandleStacksDecreased = [](UStatusEffectBase* StatusEffect, const int32 Amount)
+			{
+				static_cast<Derived*>(StatusEffect)->NativeHandleStacksDecreased(Amount);
+			};
+		}
+
+		return Dispatch;
+	}
+
+	static void TickStatusEffect(UStatusEffectBase* StatusEffect, const float DeltaTime)
+	{
+		using Config = typename Derived::FConfig;
+
+		if constexpr (HasDurationTimer())
+		{
+			StatusEffect->ProcessEffectDurationTimer(DeltaTime);
+		}
+
+		if constexpr (Config::bTickEffect)
+		{
+			if (StatusEffect->QueueBudgetedTick(DeltaTime))
+			{
+				return;
+			}
+
+			SCOPE_CYCLE_COUNTER(STAT_StatusEffects_Tick);
+
+			if constexpr (Config::TickInterval <= 0.f)
+			{
+				TRACE_STATUSEFFECT_TICKED(StatusEffect, DeltaTime);
+				static_cast<Derived*>(StatusEffect)->NativeTickEffect(DeltaTime);
+			}
+			else if (StatusEffect->TickDuration > 0.f)
+			{
+				StatusEffect->TickDuration -= DeltaTime;
+			}
+			else
+			{
+				StatusEffect->TickDuration += Config::TickInterval;
+				TRACE_STATUSEFFECT_TICKED(StatusEffect, Config::TickInterval);
+				static_cast<Derived*>(StatusEffect)->NativeTickEffect(Config::TickInterval);
+			}
+		}
+	}
+};
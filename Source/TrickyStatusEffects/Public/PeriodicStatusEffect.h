@@ -0,0 +1,129 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StatusEffectBase.h"
+#include "Curves/CurveFloat.h"
+#include "PeriodicStatusEffect.generated.h"
+
+/**
+ * Represents how stacks scale the magnitude of a periodic status effect
+ */
+UENUM(BlueprintType)
+enum class EPeriodicStatusEffectStackScaling : uint8
+{
+	None UMETA(ToolTip="Magnitude doesn't depend on stacks."),
+	Linear UMETA(ToolTip="Magnitude is multiplied by current stacks."),
+	Curve UMETA(ToolTip="Magnitude is multiplied by the stacks curve evaluated at current stacks.")
+};
+
+/**
+ * Status effect which changes an attribute of the target every period, e.g. damage or healing over time.
+ * Configured as data and processed by the status effects subsystem in a native loop without ticking the status effect.
+ * The target actor must implement IStatusEffectAttributeReceiver.
+ */
+UCLASS(Blueprintable, BlueprintType)
+class TRICKYSTATUSEFFECTS_API UPeriodicStatusEffect : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginDestroy() override;
+
+	/**
+	 * Calculates the attribute change of the next period using current stacks
+	 */
+	UFUNCTION(BlueprintPure, Category="PeriodicStatusEffect")
+	float CalculateMagnitude() const;
+
+	/**
+	 * Calculates the attribute change of a period for a given number of stacks.
+	 * Doesn't depend on the state of the instance, so it can be called on the default object from any thread.
+	 */
+	float CalculateMagnitudeForStacks(const int32 Stacks) const;
+
+	/**
+	 * Retrieves the time between attribute changes in seconds
+	 */
+	UFUNCTION(BlueprintGetter, Category="PeriodicStatusEffect")
+	float GetPeriod() const { return Period; }
+
+	/**
+	 * Retrieves the attribute changed by the status effect
+	 */
+	UFUNCTION(BlueprintGetter, Category="PeriodicStatusEffect")
+	FGameplayTag GetAttribute() const { return Attribute; }
+
+	/**
+	 * Retrieves whether the attribute is changed right after activation
+	 */
+	bool GetApplyOnActivation() const { return bApplyOnActivation; }
+
+	/**
+	 * Retrieves the time left until the next attribute change
+	 *
+	 * @return The time in seconds. -1 if the status effect isn't processed
+	 */
+	UFUNCTION(BlueprintPure, Category="PeriodicStatusEffect")
+	float GetTimeToNextPeriod() const;
+
+protected:
+	/**
+	 * The time between attribute changes in seconds
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetPeriod, Category="Periodic", meta=(ClampMin=0.01f, UIMin=0.01f))
+	float Period = 1.f;
+
+	/**
+	 * The attribute the target changes
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetAttribute, Category="Periodic")
+	FGameplayTag Attribute;
+
+	/**
+	 * The value added to the attribute each period before stack scaling. Use negative values for damage
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Periodic")
+	float Magnitude = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, Category="Periodic")
+	EPeriodicStatusEffectStackScaling StackScaling = EPeriodicStatusEffectStackScaling::Linear;
+
+	/**
+	 * Multiplier of the magnitude by current stacks
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		Category="Periodic",
+		meta=(EditCondition="StackScaling==EPeriodicStatusEffectStackScaling::Curve", EditConditionHides))
+	FRuntimeFloatCurve StacksCurve;
+
+	/**
+	 * Determines if the attribute is changed right on activation instead of after the first period
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Periodic")
+	bool bApplyOnActivation = false;
+
+	virtual void NativeActivate() override;
+
+	virtual void NativeDeactivate(AActor* Deactivator) override;
+
+	virtual void SerializeSnapshotPayload(FArchive& Ar) override;
+
+private:
+	friend class UStatusEffectsSubsystem;
+
+	/**
+	 * The index of the kernel processing the status effect in the subsystem
+	 */
+	int32 KernelIndex = INDEX_NONE;
+
+	TWeakObjectPtr<UStatusEffectsSubsystem> KernelSubsystem = nullptr;
+
+	/**
+	 * The time until the next period loaded from a snapshot. Negative if the status effect wasn't restored
+	 */
+	float RestoredTimeToNextPeriod = -1.f;
+
+	void UnregisterKernel();
+};
@@ -0,0 +1,46 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "StatusEffectAttributeModifier.generated.h"
+
+/**
+ * Represents how an attribute modifier changes the attribute value
+ */
+UENUM(BlueprintType)
+enum class EStatusEffectModifierOperation : uint8
+{
+	Add UMETA(ToolTip="Magnitude is added to the base value."),
+	Multiply UMETA(ToolTip="The value is multiplied by magnitude after all additions."),
+	Override UMETA(ToolTip="The value is replaced by magnitude. The latest applied override wins.")
+};
+
+/**
+ * Modifies an attribute while the status effect is active
+ */
+USTRUCT(BlueprintType)
+struct TRICKYSTATUSEFFECTS_API FStatusEffectAttributeModifier
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Modifier")
+	FGameplayTag Attribute;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Modifier")
+	EStatusEffectModifierOperation Operation = EStatusEffectModifierOperation::Add;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Modifier")
+	float Magnitude = 0.f;
+
+	/**
+	 * Determines if the modifier is applied once per stack.
+	 * Additions are multiplied by stacks, multipliers are raised to the power of stacks. Overrides ignore stacks.
+	 */
+	UPROPERTY(EditAnywhere,
+		BlueprintReadOnly,
+		Category="Modifier",
+		meta=(EditCondition="Operation!=EStatusEffectModifierOperation::Override"))
+	bool bScaleByStacks = true;
+};
@@ -0,0 +1,37 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/Interface.h"
+#include "StatusEffectAttributeReceiver.generated.h"
+
+class UStatusEffectBase;
+
+UINTERFACE(MinimalAPI, meta=(CannotImplementInterfaceInBlueprint))
+class UStatusEffectAttributeReceiver : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Receives attribute changes from native status effects.
+ * Implemented by target actors, so periodic status effects can change attributes without Blueprint calls.
+ */
+class TRICKYSTATUSEFFECTS_API IStatusEffectAttributeReceiver
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Changes an attribute of the target
+	 *
+	 * @param Attribute The tag of the attribute to change
+	 * @param Delta The value to add to the attribute. Negative values decrease it
+	 * @param StatusEffect The status effect changing the attribute
+	 */
+	virtual void ApplyStatusEffectAttributeDelta(const FGameplayTag& Attribute,
+	                                             const float Delta,
+	                                             UStatusEffectBase* StatusEffect) = 0;
+};
@@ -3,15 +3,31 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
 #include "UObject/Object.h"
+#include "Containers/RingBuffer.h"
 #include "Engine/Engine.h"
 #include "Tickable.h"
+#include "StatusEffectAttributeModifier.h"
+#include "StatusEffectsMemory.h"
 #include "StatusEffectBase.generated.h"
 
 class UWorld;
 class UStatusEffectsManagerComponent;
+class UStatusEffectsSubsystem;
+struct FStatusEffectNativeDispatch;
+struct FStatusEffectSnapshotRecord;
 
-DECLARE_LOG_CATEGORY_EXTERN(LogStatusEffect, Log, All)
+TRICKYSTATUSEFFECTS_API DECLARE_LOG_CATEGORY_EXTERN(LogStatusEffect, Log, All)
+
+// Activation, deactivation and restoration of status effects
+DECLARE_LOG_CATEGORY_EXTERN(LogStatusEffectLifecycle, Log, All)
+
+// Changes of status effect stacks
+DECLARE_LOG_CATEGORY_EXTERN(LogStatusEffectStacks, Log, All)
+
+// Refreshes of status effect duration timers
+DECLARE_LOG_CATEGORY_EXTERN(LogStatusEffectTimer, Log, All)
 
 /**
  * Represents status effect type
@@ -60,6 +76,50 @@ enum class EStatusEffectScope : uint8
 		ToolTip="Only one instance of status effect will be created for an instigator regardless of target."),
 };
 
+/**
+ * Represents which clients receive a replicated status effect
+ */
+UENUM(BlueprintType)
+enum class EStatusEffectReplicationPolicy : uint8
+{
+	ServerOnly UMETA(ToolTip="Status effect isn't replicated to clients."),
+	OwnerOnly UMETA(ToolTip="Status effect is replicated only to the client owning the target."),
+	Everyone UMETA(ToolTip="Status effect is replicated to all clients the target is relevant to."),
+};
+
+/**
+ * Flags of BlueprintNativeEvents overridden by a status effect class
+ */
+enum class EStatusEffectEventOverrides : uint8
+{
+	None = 0,
+	CanBeActivated = 1 << 0,
+	ActivateEffect = 1 << 1,
+	TickEffect = 1 << 2,
+	RefreshEffect = 1 << 3,
+	DeactivateEffect = 1 << 4,
+	HandleStacksIncreased = 1 << 5,
+	HandleStacksDecreased = 1 << 6,
+	// The class has a native ancestor other than UStatusEffectBase which can override any _Implementation
+	NativeImplementation = 1 << 7,
+	BlueprintEvents = CanBeActivated | ActivateEffect | TickEffect | RefreshEffect | DeactivateEffect
+	| HandleStacksIncreased | HandleStacksDecreased
+};
+
+ENUM_CLASS_FLAGS(EStatusEffectEventOverrides)
+
+/**
+ * Represents the order in which status effects tick when the tick budget is exceeded
+ */
+UENUM(BlueprintType)
+enum class EStatusEffectTickPriority : uint8
+{
+	Critical UMETA(ToolTip="Ticks every frame regardless of the tick budget."),
+	Normal UMETA(ToolTip="Ticks within the tick budget before cosmetic status effects."),
+	Cosmetic UMETA(ToolTip="Ticks within the remaining tick budget. Deferred first when the budget is exceeded."),
+	Num UMETA(Hidden)
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDeactivatedDynamicSignature,
                                              UStatusEffectBase*, StatusEffect,
                                              AActor*, Deactivator);
@@ -108,6 +168,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="StatusEffect")
 	FOnStacksDecreasedDynamicSignature OnStatusEffectStacksDecreased;
 
+	virtual void PostInitProperties() override;
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 	virtual bool IsTickable() const override;
 
 	virtual bool IsTickableWhenPaused() const override;
@@ -151,6 +215,59 @@ public:
 	UFUNCTION(BlueprintCallable, Category="StatusEffect")
 	void Deactivate(AActor* Deactivator);
 
+	/**
+	 * Activates the status effect as a proxy of a status effect replicated from the server.
+	 * Proxies only mirror the replicated state and don't run activation, tick and deactivation logic.
+	 *
+	 * @param TargetManagerComponent The manager component that owns the proxy
+	 * @param Instigator The actor responsible for applying the status effect. Can be nullptr
+	 * @param Stacks The current number of stacks replicated from the server
+	 * @param StartTime The server world time from which the elapsed time is counted
+	 * @param EndTime The server world time at which the status effect ends
+	 * @return true if the proxy was successfully activated
+	 */
+	bool ActivateAsProxy(UStatusEffectsManagerComponent* TargetManagerComponent,
+	                     AActor* Instigator,
+	                     const int32 Stacks,
+	                     const float StartTime,
+	                     const float EndTime);
+
+	/**
+	 * Applies the state replicated from the server to the proxy.
+	 * Broadcasts stacks delegates if the number of stacks has changed.
+	 *
+	 * @param Stacks The current number of stacks replicated from the server
+	 * @param StartTime The server world time from which the elapsed time is counted
+	 * @param EndTime The server world time at which the status effect ends
+	 */
+	void ApplyReplicatedState(const int32 Stacks, const float StartTime, const float EndTime);
+
+	/**
+	 * Saves the state of the status effect into a snapshot record.
+	 *
+	 * @param OutRecord The record to be populated. Class fields are filled by the manager
+	 */
+	void SaveSnapshot(FStatusEffectSnapshotRecord& OutRecord);
+
+	/**
+	 * Restores the status effect from a snapshot record without running activation logic.
+	 * If restoring fails, the object is marked as garbage
+	 *
+	 * @param TargetManagerComponent The manager component that owns the status effect
+	 * @param Instigator The actor responsible for applying the status effect. Can be nullptr
+	 * @param Record The saved state of the status effect
+	 * @return true if the status effect was successfully restored
+	 */
+	bool RestoreFromSnapshot(UStatusEffectsManagerComponent* TargetManagerComponent,
+	                         AActor* Instigator,
+	                         const FStatusEffectSnapshotRecord& Record);
+
+	/**
+	 * Checks if the status effect is a client side proxy of a status effect replicated from the server.
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffect")
+	bool GetIsReplicatedProxy() const { return bIsReplicatedProxy; }
+
 	/**
 	 * Retrieves the type of the status effect.
 	 */
@@ -163,6 +280,57 @@ public:
 	UFUNCTION(BlueprintGetter, Category="StatusEffect")
 	EStatusEffectScope GetEffectScope() const { return EffectScope; }
 
+	/**
+	 * Retrieves the tags of the status effect.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	const FGameplayTagContainer& GetEffectTags() const { return EffectTags; }
+
+	/**
+	 * Retrieves the exclusive group of the status effect.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	FGameplayTag GetExclusiveGroup() const { return ExclusiveGroup; }
+
+	/**
+	 * Retrieves the priority of the status effect in its exclusive group.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	int32 GetGroupPriority() const { return GroupPriority; }
+
+	/**
+	 * Retrieves the registry ID of the status effect class.
+	 */
+	uint16 GetClassId() const { return ClassId; }
+
+	/**
+	 * Adds memory used by the status effect to a given usage, including its delegate invocation lists.
+	 *
+	 * @param OutUsage The usage to accumulate into
+	 */
+	void AccumulateMemoryUsage(FStatusEffectsMemoryUsage& OutUsage) const;
+
+	/**
+	 * Checks if the status effect runs its tick logic.
+	 */
+	bool GetTickEffect() const { return bTickEffect; }
+
+	/**
+	 * Retrieves the tick priority of the status effect.
+	 */
+	EStatusEffectTickPriority GetTickPriority() const { return TickPriority; }
+
+	/**
+	 * Checks if the status effect ticks or has a finite duration.
+	 */
+	bool GetCanEverTick() const { return bTickEffect || !bIsInfinite && Duration > 0.f; }
+
+	/**
+	 * Retrieves the replication policy of the status effect.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	EStatusEffectReplicationPolicy GetReplicationPolicy() const { return ReplicationPolicy; }
+
 	/**
 	 * Checks if the status effect has an infinite duration.
 	 */
@@ -193,6 +361,18 @@ public:
 	UFUNCTION(BlueprintGetter, Category="StatusEffect")
 	float GetDeltaDuration() const { return DeltaDuration; }
 
+	/**
+	 * Retrieves the server world time from which the elapsed time of the status effect is counted.
+	 * Updated only on activation and timer refresh. Returns -1.0f for infinite status effects.
+	 */
+	float GetTimerStartTime() const { return TimerStartTime; }
+
+	/**
+	 * Retrieves the server world time at which the status effect ends.
+	 * Updated only on activation and timer refresh. Returns -1.0f for infinite status effects.
+	 */
+	float GetTimerEndTime() const { return TimerEndTime; }
+
 	/**
 	 * Retrieves the remaining time for the status effect.
 	 * If the status effect has an infinite duration, it returns -1.0f.
@@ -225,6 +405,21 @@ public:
 	UFUNCTION(BlueprintGetter, Category="StatusEffect")
 	int32 GetMaxStacks() const { return MaxStacks; }
 
+	/**
+	 * Retrieves whether each stack expires on its own.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	bool GetHasIndependentStackDurations() const { return bIndependentStackDurations; }
+
+	/**
+	 * Retrieves the remaining time of a stack. Stacks are ordered from the oldest to the newest.
+	 * If stacks don't expire independently, it returns the remaining time of the status effect.
+	 *
+	 * @param StackIndex The index of the stack, 0 is the stack which expires first
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffect")
+	float GetStackRemainingTime(const int32 StackIndex) const;
+
 	/**
 	 * Retrieves the current number of stacks.
 	 */
@@ -237,6 +432,12 @@ public:
 	UFUNCTION(BlueprintGetter, Category="StatusEffect")
 	EStatusEffectStacksRefreshBehavior GetStacksBehavior() const { return StacksBehavior; }
 
+	/**
+	 * Retrieves attribute modifiers applied by the status effect while it's active.
+	 */
+	UFUNCTION(BlueprintGetter, Category="StatusEffect")
+	const TArray<FStatusEffectAttributeModifier>& GetAttributeModifiers() const { return AttributeModifiers; }
+
 	/**
 	 * Retrieves the delta value for status effect stacks which will be added on refresh.
 	 */
@@ -263,9 +464,10 @@ public:
 
 	/**
 	 * Increases the number of stacks for the status effect by the given amount.
+	 * With independent stack durations, stacks above MaxStacks renew the oldest stacks.
 	 *
 	 * @param Amount The number of stacks to add to current stacks. Must be greater than 0
-	 * @return true if the stacks were successfully increased
+	 * @return true if the stacks were increased or renewed
 	 */
 	UFUNCTION(BlueprintCallable, Category="StatusEffect")
 	bool IncreaseStacks(const int32 Amount = 1);
@@ -362,7 +564,42 @@ protected:
 	{
 	}
 
+	/**
+	 * Runs native activation logic after ActivateEffect and after restoring from a snapshot.
+	 * Unlike ActivateEffect, can't be replaced by Blueprints. Not called on replicated proxies.
+	 */
+	virtual void NativeActivate()
+	{
+	}
+
+	/**
+	 * Runs native deactivation logic after DeactivateEffect. Unlike DeactivateEffect, can't be replaced by Blueprints.
+	 * Not called on replicated proxies.
+	 *
+	 * @param Deactivator The actor responsible for deactivating the status effect
+	 */
+	virtual void NativeDeactivate(AActor* Deactivator)
+	{
+	}
+
+	/**
+	 * Saves and loads custom state of the status effect in snapshots.
+	 * Called on the game thread.
+	 *
+	 * @param Ar The archive to serialize custom state with
+	 */
+	virtual void SerializeSnapshotPayload(FArchive& Ar)
+	{
+	}
+
 private:
+	friend class UStatusEffectsSubsystem;
+
+	friend class UStatusEffectsRegistry;
+
+	template <typename>
+	friend class TStatusEffect;
+
 	virtual void Tick(float DeltaTime) override;
 
 	virtual TStatId GetStatId() const override;
@@ -370,7 +607,7 @@ private:
 	/**
 	 * Determines if status effect can tick
 	 */
-	UPROPERTY(EditDefaultsOnly, Category="Tick")
+	UPROPERTY(EditDefaultsOnly, AssetRegistrySearchable, Category="Tick")
 	bool bTickEffect = false;
 
 	/**
@@ -381,41 +618,64 @@ private:
 	float TickInterval = 0.0f;
 
 	/**
-	 * Represents the duration of each tick in seconds for a status effect.
-	 * A negative value signifies an uninitialized or inactive state.
+	 * Determines which status effects tick first when ticks exceed StatusEffects.TickBudgetMs.
+	 * Deferred ticks receive the accumulated delta time. Duration timers are never deferred.
 	 */
-	float TickDuration = -1.0f;
+	UPROPERTY(EditDefaultsOnly, Category="Tick", meta=(EditCondition="bTickEffect"))
+	EStatusEffectTickPriority TickPriority = EStatusEffectTickPriority::Normal;
+
+	UPROPERTY(EditDefaultsOnly, AssetRegistrySearchable, BlueprintGetter=GetEffectType, Category="General")
+	EStatusEffectType EffectType = EStatusEffectType::Neutral;
+
+	UPROPERTY(EditDefaultsOnly, AssetRegistrySearchable, BlueprintGetter=GetEffectScope, Category="General")
+	EStatusEffectScope EffectScope = EStatusEffectScope::PerTarget;
 
 	/**
-	 * The last frame number we were ticked.
-	 * We don't want to tick multiple times per frame
+	 * Tags describing the status effect. Used to find status effects in the catalog without loading them.
 	 */
-	uint32 LastFrameNumberWeTicked = INDEX_NONE;
+	UPROPERTY(EditDefaultsOnly, AssetRegistrySearchable, BlueprintGetter=GetEffectTags, Category="General")
+	FGameplayTagContainer EffectTags;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetEffectType, Category="General")
-	EStatusEffectType EffectType = EStatusEffectType::Neutral;
+	/**
+	 * Only one status effect of an exclusive group can be active on a target, e.g. one food buff at a time.
+	 * Applying a status effect replaces the active member of its group unless the member has a higher priority.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetExclusiveGroup, Category="Group")
+	FGameplayTag ExclusiveGroup;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetEffectScope, Category="General")
-	EStatusEffectScope EffectScope = EStatusEffectScope::PerTarget;
+	/**
+	 * Determines whether the status effect can replace the active member of its exclusive group.
+	 * Members with equal priority replace each other, so the most recent one stays.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetGroupPriority, Category="Group")
+	int32 GroupPriority = 0;
+
+	/**
+	 * Determines which clients receive the status effect.
+	 * Use ServerOnly or OwnerOnly for internal bookkeeping effects to save bandwidth.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		AssetRegistrySearchable,
+		BlueprintGetter=GetReplicationPolicy,
+		Category="Replication")
+	EStatusEffectReplicationPolicy ReplicationPolicy = EStatusEffectReplicationPolicy::Everyone;
 
 	/**
 	 * Indicates whether the status effect has an infinite duration.
 	 */
-	UPROPERTY(EditDefaultsOnly, Category="Duration")
+	UPROPERTY(EditDefaultsOnly, AssetRegistrySearchable, Category="Duration")
 	bool bIsInfinite = true;
 
 	/**
 	 * Determines status effect duration in seconds
 	 */
 	UPROPERTY(EditDefaultsOnly,
+		AssetRegistrySearchable,
 		BlueprintGetter=GetDuration,
 		Category="Duration",
 		meta=(ClampMin=0.0f, UIMin=0.0f, Delta=1, EditCondition="!bIsInfinite", ForceUnits="Seconds"))
 	float Duration = 5.0f;
 
-	UPROPERTY()
-	float RemainingDuration = -1.0f;
-
 	/**
 	 * Determines status effects calculations on status effect refresh
 	 */
@@ -470,8 +730,16 @@ private:
 		meta=(ClampMin=1, UIMin=1, EditCondition="bIsStackable"))
 	int32 MaxStacks = 5;
 
-	UPROPERTY(BlueprintGetter=GetCurrentStacks, Category="Stacks")
-	int32 CurrentStacks = 0;
+	/**
+	 * Determines whether each stack expires Duration seconds after it was added, removing one stack at a time.
+	 * The status effect ends when its last stack expires. TimerBehavior is ignored,
+	 * and increasing stacks at MaxStacks renews the oldest stacks.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetHasIndependentStackDurations,
+		Category="Stacks",
+		meta=(EditCondition="bIsStackable && !bIsInfinite"))
+	bool bIndependentStackDurations = false;
 
 	/**
 	 * Determines how stacks will be calculated on refresh
@@ -489,6 +757,80 @@ private:
 			EditCondition="bIsStackable && StacksBehavior == EStatusEffectStacksRefreshBehavior::Increase"))
 	int32 DeltaStacks = 1;
 
+	/**
+	 * Attribute modifiers aggregated by the owning manager while the status effect is active.
+	 * Use them instead of applying and reverting modifications in ActivateEffect and DeactivateEffect.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetAttributeModifiers, Category="Modifiers")
+	TArray<FStatusEffectAttributeModifier> AttributeModifiers;
+
+	/**
+	 * Represents the duration of each tick in seconds for a status effect.
+	 * A negative value signifies an uninitialized or inactive state.
+	 */
+	float TickDuration = -1.0f;
+
+	/**
+	 * The last frame number we were ticked.
+	 * We don't want to tick multiple times per frame
+	 */
+	uint32 LastFrameNumberWeTicked = INDEX_NONE;
+
+	/**
+	 * Delta time accumulated while the tick is waiting for the tick budget.
+	 */
+	float PendingTickDeltaTime = 0.f;
+
+	bool bIsTickQueued = false;
+
+	/**
+	 * Events of the class which have to be dispatched through the Blueprint VM or its native implementation.
+	 * Cached from the registry on creation. Unknown overrides fall back to the regular dispatch.
+	 */
+	EStatusEffectEventOverrides EventOverrides = EStatusEffectEventOverrides::BlueprintEvents
+		| EStatusEffectEventOverrides::NativeImplementation;
+
+	/**
+	 * Statically dispatched handlers of a TStatusEffect class. nullptr for other classes and their Blueprint subclasses.
+	 */
+	const FStatusEffectNativeDispatch* NativeDispatch = nullptr;
+
+	/**
+	 * Indicates whether the status effect is a client side proxy of a replicated status effect.
+	 */
+	bool bIsReplicatedProxy = false;
+
+	/**
+	 * The registry ID of the status effect class. Cached on creation.
+	 * The class default object caches it on the first registry lookup of the class.
+	 */
+	uint16 ClassId = 0;
+
+	UPROPERTY()
+	float RemainingDuration = -1.0f;
+
+	/**
+	 * Server world time stamps of the duration timer.
+	 * Replicated instead of the remaining duration to let clients count down locally.
+	 */
+	float TimerStartTime = -1.0f;
+
+	float TimerEndTime = -1.0f;
+
+	UPROPERTY(BlueprintGetter=GetCurrentStacks, Category="Stacks")
+	int32 CurrentStacks = 0;
+
+	/**
+	 * Expiry times of stacks ordered from the oldest to the newest, if stacks expire independently.
+	 * Stacks are added with the same duration, so the oldest stack always expires first.
+	 */
+	TRingBuffer<float> StackExpiryTimes;
+
+	/**
+	 * Time counted by the duration timer since activation. Expiry times of stacks are relative to it.
+	 */
+	float StackTimerTime = 0.f;
+
 	/**
 	 * Holds a reference to the target actor affected by the status effect.
 	 */
@@ -509,19 +851,32 @@ private:
 
 	void ProcessTick(float DeltaTime);
 
+	/**
+	 * Queues the tick into the tick budget of the world if it's enabled.
+	 *
+	 * @return true if the tick was queued or dropped
+	 */
+	bool QueueBudgetedTick(float DeltaTime);
+
 	void ProcessEffectDurationTimer(float DeltaTime);
 
 	void RefreshTimer();
 
+	void UpdateTimerStamps();
+
 	void RefreshStacks();
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	static void PrintLog(const FString& Message);
+	bool HasStackDurations() const { return bIsStackable && bIndependentStackDurations && !bIsInfinite; }
 
-	static void PrintWarning(const FString& Message);
+	/**
+	 * Adds expiry times for new stacks. Renews the oldest stacks if there are already MaxStacks of them.
+	 */
+	void AddStackExpiryTimes(const int32 Amount);
 
-	static void PrintError(const FString& Message);
+	/**
+	 * Makes all current stacks expire after a given time.
+	 */
+	void ResetStackExpiryTimes(const float RemainingTime);
 
-	static void GetActorName(AActor* Actor, FString& OutName);
-#endif 
+	void ProcessStackExpiryTimes(float DeltaTime);
 };
@@ -0,0 +1,195 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+#define STATUSEFFECTS_JOURNAL_ENABLED 1
+#else
+#define STATUSEFFECTS_JOURNAL_ENABLED 0
+#endif
+
+#if STATUSEFFECTS_JOURNAL_ENABLED
+class UStatusEffectBase;
+class UWorld;
+class FStatusEffectsJournalReplay;
+
+/**
+ * Represents a journaled status effect event
+ */
+enum class EStatusEffectJournalEvent : uint8
+{
+	Activated,
+	Refreshed,
+	StacksChanged,
+	Deactivated
+};
+
+/**
+ * A single event of the status effects journal
+ */
+struct TRICKYSTATUSEFFECTS_API FStatusEffectJournalRecord
+{
+	/**
+	 * Seconds since the recording started
+	 */
+	float Time = 0.f;
+
+	/**
+	 * Unique IDs of objects at the moment of recording. 0 if there was no object
+	 */
+	uint32 EffectId = 0;
+
+	uint32 TargetId = 0;
+
+	uint32 InstigatorId = 0;
+
+	uint16 ClassId = 0;
+
+	EStatusEffectJournalEvent Event = EStatusEffectJournalEvent::Activated;
+
+	/**
+	 * Stacks after the event
+	 */
+	int32 Stacks = 0;
+
+	/**
+	 * Stacks added or removed by a StacksChanged event
+	 */
+	int32 StacksDelta = 0;
+
+	/**
+	 * Remaining time after the event. -1 for infinite status effects
+	 */
+	float RemainingTime = -1.f;
+
+	friend FArchive& operator<<(FArchive& Ar, FStatusEffectJournalRecord& Record);
+};
+
+/**
+ * Records lifecycle events of status effects into a binary ring buffer which can be saved to a file
+ * and replayed against headless managers to reproduce load patterns offline.
+ * Recording is done on the game thread.
+ */
+class TRICKYSTATUSEFFECTS_API FStatusEffectsJournal
+{
+public:
+	enum class EVersion : uint16
+	{
+		Initial = 1,
+
+		LatestPlusOne,
+		Latest = LatestPlusOne - 1
+	};
+
+	/**
+	 * Stack changes made by a refresh aren't recorded separately, as replaying the Refreshed event repeats them
+	 */
+	struct FRefreshScope
+	{
+		explicit FRefreshScope(const UStatusEffectBase* StatusEffect)
+			: PreviousStatusEffect(Get().RefreshingStatusEffect)
+		{
+			Get().RefreshingStatusEffect = StatusEffect;
+		}
+
+		~FRefreshScope()
+		{
+			Get().RefreshingStatusEffect = PreviousStatusEffect;
+		}
+
+	private:
+		const UStatusEffectBase* PreviousStatusEffect = nullptr;
+	};
+
+	~FStatusEffectsJournal();
+
+	static FStatusEffectsJournal& Get();
+
+	static bool IsRecording() { return bIsRecording; }
+
+	/**
+	 * Starts recording. Previously recorded events are discarded
+	 *
+	 * @param Capacity The maximum number of events kept. The oldest events are overwritten when it's exceeded
+	 */
+	void StartRecording(const int32 Capacity);
+
+	void StopRecording();
+
+	/**
+	 * Records an event of a given status effect. Events of replicated proxies are ignored
+	 */
+	void Record(const EStatusEffectJournalEvent Event, const UStatusEffectBase* StatusEffect, const int32 StacksDelta = 0);
+
+	/**
+	 * Retrieves recorded events from the oldest to the newest
+	 */
+	void GetRecords(TArray<FStatusEffectJournalRecord>& OutRecords) const;
+
+	/**
+	 * Saves recorded events along with paths of their classes
+	 *
+	 * @return true if the file was written
+	 */
+	bool SaveToFile(const FString& FilePath) const;
+
+	/**
+	 * Loads events and class paths saved with SaveToFile
+	 *
+	 * @return true if the file was successfully read
+	 */
+	static bool LoadFromFile(const FString& FilePath,
+	                         TArray<FStatusEffectJournalRecord>& OutRecords,
+	                         TMap<uint16, FString>& OutClassPaths);
+
+	/**
+	 * Replays events in real time. Each recorded target gets a headless actor with a manager component.
+	 *
+	 * @return true if the replay was started
+	 */
+	bool StartReplay(UWorld* World,
+	                 TArray<FStatusEffectJournalRecord>&& Records,
+	                 TMap<uint16, FString>&& ClassPaths);
+
+	/**
+	 * Stops the replay and destroys its actors
+	 */
+	void StopReplay();
+
+private:
+	static constexpr uint32 Magic = 0x53454a52;
+
+	static bool bIsRecording;
+
+	TArray<FStatusEffectJournalRecord> RingBuffer;
+
+	int32 NextIndex = 0;
+
+	int32 NumRecords = 0;
+
+	double StartTime = 0.0;
+
+	const UStatusEffectBase* RefreshingStatusEffect = nullptr;
+
+	TUniquePtr<FStatusEffectsJournalReplay> Replay;
+
+	FDelegateHandle EnginePreExitHandle;
+};
+
+#define RECORD_STATUSEFFECT_EVENT(Event, StatusEffect, ...) \
+	do \
+	{ \
+		if (FStatusEffectsJournal::IsRecording()) \
+		{ \
+			FStatusEffectsJournal::Get().Record(EStatusEffectJournalEvent::Event, StatusEffect, ##__VA_ARGS__); \
+		} \
+	} while (false)
+
+#define RECORD_STATUSEFFECT_REFRESH_SCOPE(StatusEffect) \
+	const FStatusEffectsJournal::FRefreshScope ANONYMOUS_VARIABLE(StatusEffectsJournalRefreshScope)(StatusEffect)
+#else
+#define RECORD_STATUSEFFECT_EVENT(Event, StatusEffect, ...)
+#define RECORD_STATUSEFFECT_REFRESH_SCOPE(StatusEffect)
+#endif
@@ -42,6 +42,38 @@ public:
 	                                            TSubclassOf<UStatusEffectBase> StatusEffect,
 	                                            AActor* Instigator);
 
+	/**
+	 * Applies a soft referenced status effect to a given actor
+	 * If the class isn't loaded, it's loaded asynchronously and the status effect is applied once loading finishes
+	 *
+	 * @param Target The actor to which the status effect will be applied
+	 * @param StatusEffect The class of the status effect to be applied
+	 * @param Instigator The actor which applied a status effect. Can be nullptr
+	 * @return A pointer to the applied status effect object. nullptr if the apply is pending
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects", meta=(WorldContext="Target"))
+	static UStatusEffectBase* ApplySoftStatusEffect(AActor* Target,
+	                                                TSoftClassPtr<UStatusEffectBase> StatusEffect,
+	                                                AActor* Instigator);
+
+	/**
+	 * Asynchronously loads status effect classes and keeps them loaded until the preload group is released
+	 *
+	 * @param PreloadGroup The name of the group the classes are kept loaded by, e.g. an ability loadout or a map
+	 * @param StatusEffects The classes to load
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	static void PreloadStatusEffects(const FName PreloadGroup,
+	                                 const TArray<TSoftClassPtr<UStatusEffectBase>>& StatusEffects);
+
+	/**
+	 * Lets classes of a preload group be unloaded
+	 *
+	 * @param PreloadGroup The name of the group to release
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	static void ReleasePreloadedStatusEffects(const FName PreloadGroup);
+
 	/**
 	 * Refreshes all applied status effects
 	 * 
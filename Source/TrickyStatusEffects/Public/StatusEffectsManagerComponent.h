@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "StatusEffectBase.h"
+#include "StatusEffectsReplication.h"
+#include "StatusEffectsSnapshot.h"
 #include "Components/ActorComponent.h"
 #include "StatusEffectsManagerComponent.generated.h"
 
@@ -23,6 +25,10 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnStatusEffectRefreshedDynamicSign
                                              UStatusEffectsManagerComponent*, Component,
                                              UStatusEffectBase*, StatusEffect);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAttributeModifiersChangedDynamicSignature,
+                                             UStatusEffectsManagerComponent*, Component,
+                                             FGameplayTag, Attribute);
+
 /**
  * Responsible for managing status effects applied to an actor.
  */
@@ -52,8 +58,32 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="StatusEffects")
 	FOnStatusEffectRefreshedDynamicSignature OnStatusEffectRefreshed;
 
+	/**
+	 * Called when modifiers of an attribute were applied, removed or their stacks changed
+	 */
+	UPROPERTY(BlueprintAssignable, Category="StatusEffects")
+	FOnAttributeModifiersChangedDynamicSignature OnAttributeModifiersChanged;
+
+	virtual void OnRegister() override;
+
+	virtual void OnUnregister() override;
+
 	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Exclusive size covers delegates and containers of the manager.
+	 * Inclusive size also covers the applied status effects.
+	 */
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	/**
+	 * Retrieves the world time synchronized with the server.
+	 * Falls back to the local world time if there's no game state.
+	 */
+	float GetServerWorldTime() const;
+
 	/**
 	 * Applies a status effect
 	 * If the effect is already applied and its scope is not PerInstance, it will refresh it
@@ -65,6 +95,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category="StatusEffects")
 	UStatusEffectBase* ApplyStatusEffect(TSubclassOf<UStatusEffectBase> StatusEffect, AActor* Instigator);
 
+	/**
+	 * Applies a soft referenced status effect
+	 * If the class isn't loaded, it's loaded asynchronously and the status effect is applied once loading finishes
+	 *
+	 * @param StatusEffect The class of the status effect to be applied
+	 * @param Instigator The actor which applied a status effect. Can be nullptr
+	 * @return A pointer to the applied status effect object. nullptr if the apply is pending
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	UStatusEffectBase* ApplySoftStatusEffect(TSoftClassPtr<UStatusEffectBase> StatusEffect, AActor* Instigator);
+
+	/**
+	 * Checks if there are status effects waiting for their classes to be loaded
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool HasPendingStatusEffects() const { return !PendingStatusEffects.IsEmpty(); }
+
 	/**
 	 * Refreshes all applied status effects
 	 */
@@ -261,6 +308,15 @@ public:
 	UFUNCTION(BlueprintPure, Category="StatusEffects")
 	UStatusEffectBase* GetStatusEffect(TSubclassOf<UStatusEffectBase> StatusEffect) const;
 
+	/**
+	 * Retrieves the active status effect of an exclusive group
+	 *
+	 * @param ExclusiveGroup The exclusive group to retrieve the status effect of
+	 * @return A pointer to the status effect object instance. Can be nullptr
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	UStatusEffectBase* GetStatusEffectInGroup(const FGameplayTag ExclusiveGroup) const;
+
 	/**
 	 * Retrieves a status effect of the specified class that was applied by the given instigator
 	 *
@@ -280,6 +336,31 @@ public:
 	UFUNCTION(BlueprintPure, Category="StatusEffects")
 	void GetAllStatusEffects(TArray<UStatusEffectBase*>& OutStatusEffects) const;
 
+	/**
+	 * Applies modifiers of active status effects to a base value of an attribute.
+	 * Modifiers are aggregated only when they change, so reading an attribute is cheap.
+	 *
+	 * @param Attribute The attribute to calculate
+	 * @param BaseValue The value of the attribute without modifiers
+	 * @return (BaseValue + additions) * multipliers, or the latest override
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	float GetModifiedAttributeValue(const FGameplayTag Attribute, const float BaseValue) const;
+
+	/**
+	 * Checks if any active status effect modifies an attribute
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool HasAttributeModifiers(const FGameplayTag Attribute) const { return AttributeAggregates.Contains(Attribute); }
+
+	/**
+	 * Adds memory used by the manager itself to a given usage, excluding its status effects.
+	 * Covers delegate invocation lists, arrays of status effects and replicated records along with their slack.
+	 *
+	 * @param OutUsage The usage to accumulate into
+	 */
+	void AccumulateMemoryUsage(FStatusEffectsMemoryUsage& OutUsage) const;
+
 	/**
 	 * Retrieves all status effects of a specific class
 	 *
@@ -333,18 +414,164 @@ public:
 	                                             EStatusEffectType StatusEffectType,
 	                                             AActor* Instigator) const;
 
+	/**
+	 * Saves all applied status effects into a compact versioned binary snapshot.
+	 * Replicated proxies aren't saved
+	 *
+	 * @param OutData The array to be populated with the snapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	void SaveStatusEffectsSnapshot(TArray<uint8>& OutData) const;
+
+	/**
+	 * Restores status effects from a binary snapshot without running their activation logic and delegates.
+	 * Restored status effects are added to the currently applied ones
+	 *
+	 * @param Data The binary snapshot created by SaveStatusEffectsSnapshot
+	 * @return The number of restored status effects
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	int32 RestoreStatusEffectsSnapshot(const TArray<uint8>& Data);
+
+	/**
+	 * Restores status effects from a decoded snapshot without running their activation logic and delegates.
+	 * The snapshot can be decoded off the game thread beforehand
+	 *
+	 * @param Snapshot The decoded snapshot
+	 * @return The number of restored status effects
+	 */
+	int32 RestoreStatusEffectsFromSnapshot(const FStatusEffectsSnapshot& Snapshot);
+
 private:
+	friend struct FReplicatedStatusEffect;
+
 	UPROPERTY(VisibleInstanceOnly, Category="StatusEffects")
 	TArray<UStatusEffectBase*> AppliedStatusEffects;
 
+	/**
+	 * Represents a status effect waiting for its class to be loaded
+	 */
+	struct FPendingStatusEffect
+	{
+		TSoftClassPtr<UStatusEffectBase> StatusEffect;
+
+		TWeakObjectPtr<AActor> Instigator;
+	};
+
+	TArray<FPendingStatusEffect> PendingStatusEffects;
+
+	/**
+	 * Aggregated modifiers of an attribute. Recalculated on read after its status effects changed
+	 */
+	struct FAttributeAggregate
+	{
+		/**
+		 * Active status effects modifying the attribute in order of application
+		 */
+		TArray<UStatusEffectBase*> StatusEffects;
+
+		float Addition = 0.f;
+
+		float Multiplier = 1.f;
+
+		float OverrideValue = 0.f;
+
+		bool bHasOverride = false;
+
+		bool bIsDirty = true;
+	};
+
+	mutable TMap<FGameplayTag, FAttributeAggregate> AttributeAggregates;
+
+	/**
+	 * Bits of registry class IDs of active status effects. Checked against compiled interaction rules on apply
+	 */
+	TBitArray<> ActiveClassIds;
+
+	/**
+	 * Active status effects by their exclusive groups
+	 */
+	TMap<FGameplayTag, UStatusEffectBase*> ExclusiveGroupSlots;
+
+	/**
+	 * Delta replicated records of status effects visible to all clients
+	 */
+	UPROPERTY(Replicated)
+	FReplicatedStatusEffectsList ReplicatedStatusEffects;
+
+	/**
+	 * Delta replicated records of status effects visible only to the owning client
+	 */
+	UPROPERTY(Replicated)
+	FReplicatedStatusEffectsList OwnerReplicatedStatusEffects;
+
+	/**
+	 * The registry hash of the server. Clients ignore replicated status effects if it doesn't match theirs
+	 */
+	UPROPERTY(Replicated)
+	uint32 RegistryHash = 0;
+
 	UFUNCTION()
 	void HandleStatusEffectDeactivated(UStatusEffectBase* StatusEffect, AActor* Deactivator);
 
 	UFUNCTION()
 	void HandleStatusEffectRefreshed(UStatusEffectBase* StatusEffect);
 
+	UFUNCTION()
+	void HandleStatusEffectStacksChanged(UStatusEffectBase* StatusEffect, int32 NewStacks);
+
+	bool CanReplicateStatusEffects() const;
+
+	FReplicatedStatusEffectsList* GetReplicatedStatusEffectsList(const UStatusEffectBase* StatusEffect);
+
+	void HandleReplicatedStatusEffectAdded(FReplicatedStatusEffect& Entry);
+
+	void HandleReplicatedStatusEffectChanged(FReplicatedStatusEffect& Entry);
+
+	void HandleReplicatedStatusEffectRemoved(FReplicatedStatusEffect& Entry);
+
 	UStatusEffectBase* CreateNewStatusEffect(const TSubclassOf<UStatusEffectBase>& StatusEffect, AActor* Instigator);
 
+	void RegisterStatusEffect(UStatusEffectBase* StatusEffect, AActor* Instigator);
+
+	void HandleStatusEffectClassLoaded(TSoftClassPtr<UStatusEffectBase> StatusEffect);
+
+	/**
+	 * Checks if a status effect is blocked by active status effects
+	 */
+	bool IsBlockedByInteractionRules(const TSubclassOf<UStatusEffectBase> StatusEffect) const;
+
+	/**
+	 * Removes active status effects cancelled by a status effect which has been applied
+	 */
+	void CancelByInteractionRules(const UStatusEffectBase* AppliedStatusEffect, AActor* Instigator);
+
+	/**
+	 * Finds the active member of the exclusive group of a status effect which the status effect would replace
+	 *
+	 * @param OutReplacedStatusEffect The member to deactivate once the status effect is applied. nullptr if there is none
+	 * @return false if the status effect can't be applied
+	 */
+	bool ResolveExclusiveGroup(const UStatusEffectBase* StatusEffectCDO,
+	                           AActor* Instigator,
+	                           UStatusEffectBase*& OutReplacedStatusEffect) const;
+
+	void AddToExclusiveGroup(UStatusEffectBase* StatusEffect);
+
+	void RemoveFromExclusiveGroup(const UStatusEffectBase* StatusEffect);
+
+	void AddActiveClassId(const UStatusEffectBase* StatusEffect);
+
+	void RemoveActiveClassId(const UStatusEffectBase* StatusEffect);
+
+	void AddAttributeModifiers(UStatusEffectBase* StatusEffect);
+
+	void RemoveAttributeModifiers(UStatusEffectBase* StatusEffect);
+
+	void MarkAttributeModifiersDirty(const UStatusEffectBase* StatusEffect);
+
+	static void AggregateAttributeModifiers(const FGameplayTag& Attribute, FAttributeAggregate& Aggregate);
+
 	static void RefreshGivenStatusEffects(TArray<UStatusEffectBase*>& StatusEffects);
 
 	static void RemoveGivenStatusEffects(TArray<UStatusEffectBase*>& StatusEffects, AActor* Remover);
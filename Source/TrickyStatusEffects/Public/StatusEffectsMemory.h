@@ -0,0 +1,60 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Memory used by status effects and their managers
+ */
+struct FStatusEffectsMemoryUsage
+{
+	/**
+	 * Size of the objects themselves
+	 */
+	SIZE_T ObjectBytes = 0;
+
+	/**
+	 * Heap memory of delegate invocation lists
+	 */
+	SIZE_T DelegateBytes = 0;
+
+	/**
+	 * Heap memory of arrays and maps, including their slack
+	 */
+	SIZE_T ContainerBytes = 0;
+
+	/**
+	 * Allocated but unused memory of arrays. Already counted in ContainerBytes
+	 */
+	SIZE_T SlackBytes = 0;
+
+	SIZE_T GetTotalBytes() const { return ObjectBytes + DelegateBytes + ContainerBytes; }
+
+	/**
+	 * Retrieves heap memory owned by the objects, i.e. their exclusive resource size
+	 */
+	SIZE_T GetHeapBytes() const { return DelegateBytes + ContainerBytes; }
+
+	template <typename ElementType, typename AllocatorType>
+	void AddArray(const TArray<ElementType, AllocatorType>& Array)
+	{
+		ContainerBytes += Array.GetAllocatedSize();
+		SlackBytes += static_cast<SIZE_T>(Array.GetSlack()) * sizeof(ElementType);
+	}
+
+	template <typename DelegateType>
+	void AddDelegate(const DelegateType& Delegate)
+	{
+		DelegateBytes += Delegate.GetAllocatedSize();
+	}
+
+	FStatusEffectsMemoryUsage& operator+=(const FStatusEffectsMemoryUsage& Other)
+	{
+		ObjectBytes += Other.ObjectBytes;
+		DelegateBytes += Other.DelegateBytes;
+		ContainerBytes += Other.ContainerBytes;
+		SlackBytes += Other.SlackBytes;
+		return *this;
+	}
+};
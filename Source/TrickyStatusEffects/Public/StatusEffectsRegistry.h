@@ -0,0 +1,285 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "StatusEffectBase.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/TopLevelAssetPath.h"
+#include "StatusEffectsRegistry.generated.h"
+
+struct FAssetData;
+
+DECLARE_DYNAMIC_DELEGATE(FOnStatusEffectsPreloadedDynamicSignature);
+
+/**
+ * Precomputed traits of a status effect class
+ */
+USTRUCT(BlueprintType)
+struct TRICKYSTATUSEFFECTS_API FStatusEffectCatalogEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	TSoftClassPtr<UStatusEffectBase> StatusEffectClass = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	EStatusEffectType EffectType = EStatusEffectType::Neutral;
+
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	EStatusEffectScope EffectScope = EStatusEffectScope::PerTarget;
+
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	EStatusEffectReplicationPolicy ReplicationPolicy = EStatusEffectReplicationPolicy::Everyone;
+
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	FGameplayTagContainer EffectTags;
+
+	/**
+	 * Indicates whether the status effect ticks or has a finite duration
+	 */
+	UPROPERTY(BlueprintReadOnly, Category="StatusEffects")
+	bool bCanEverTick = false;
+
+	/**
+	 * The registry ID of the status effect class
+	 */
+	uint16 ClassId = 0;
+
+	/**
+	 * Overridden events. Known only after the class was loaded
+	 */
+	EStatusEffectEventOverrides EventOverrides = EStatusEffectEventOverrides::None;
+
+	bool bAreEventOverridesKnown = false;
+};
+
+/**
+ * Catalog of all status effect classes.
+ * Assigns stable dense 16-bit IDs and keeps precomputed traits of every class in a single table indexed by ID.
+ * IDs are assigned on the first lookup by sorting paths of Blueprint status effect classes found in the asset registry
+ * and native status effect classes of runtime modules, which every build of the project shares,
+ * so the server and clients resolve the same IDs without exporting classes.
+ * Classes missing from that table, e.g. classes of editor or developer modules, are appended on their first lookup.
+ * IDs are never reassigned. The registry hash covers all class paths in ID order, so mismatching IDs are detected.
+ * Traits of Blueprint classes are read from asset registry tags, so the catalog doesn't load them.
+ */
+UCLASS()
+class TRICKYSTATUSEFFECTS_API UStatusEffectsRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Reserved ID of an unknown or invalid status effect class
+	 */
+	static constexpr uint16 InvalidClassId = 0;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Retrieves the registry instance. Can be nullptr before the engine is initialized
+	 */
+	static UStatusEffectsRegistry* Get();
+
+	/**
+	 * Retrieves the ID of a given status effect class.
+	 * IDs are appended for classes which weren't in the registry when it was built.
+	 * The ID is cached on the class default object, so a class is looked up by its path only once.
+	 *
+	 * @param StatusEffectClass The class to retrieve the ID for
+	 * @return The class ID or InvalidClassId if the class isn't registered
+	 */
+	uint16 GetClassId(const UClass* StatusEffectClass);
+
+	/**
+	 * Retrieves the path of the status effect class with a given ID
+	 *
+	 * @return The class path. Empty if the ID isn't registered
+	 */
+	FTopLevelAssetPath GetClassPath(const uint16 ClassId) const;
+
+	/**
+	 * Retrieves the status effect class with a given ID.
+	 * Loads the class synchronously if it isn't loaded yet.
+	 *
+	 * @return The status effect class. Can be nullptr
+	 */
+	TSubclassOf<UStatusEffectBase> ResolveClass(const uint16 ClassId);
+
+	/**
+	 * Retrieves the catalog entry of the status effect class with a given ID
+	 *
+	 * @return A pointer to the entry. Can be nullptr
+	 */
+	const FStatusEffectCatalogEntry* GetCatalogEntry(const uint16 ClassId) const;
+
+	/**
+	 * Retrieves the catalog entry of a given loaded status effect class.
+	 * Event overrides of the entry are calculated on the first call.
+	 *
+	 * @return A pointer to the entry. Can be nullptr
+	 */
+	const FStatusEffectCatalogEntry* GetCatalogEntry(const UClass* StatusEffectClass);
+
+	/**
+	 * Retrieves the number of registered status effect classes
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	int32 GetNumClasses() const { return FMath::Max(Entries.Num() - 1, 0); }
+
+	/**
+	 * Retrieves all status effect classes of a given type without loading them
+	 *
+	 * @param StatusEffectType The type of status effects to filter
+	 * @param OutStatusEffects The array to be populated with matching status effect classes
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	void GetStatusEffectClassesOfType(const EStatusEffectType StatusEffectType,
+	                                  TArray<TSoftClassPtr<UStatusEffectBase>>& OutStatusEffects);
+
+	/**
+	 * Retrieves all status effect classes which have any of given tags without loading them
+	 *
+	 * @param EffectTags The tags to filter status effects by
+	 * @param OutStatusEffects The array to be populated with matching status effect classes
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	void GetStatusEffectClassesWithAnyTags(const FGameplayTagContainer& EffectTags,
+	                                       TArray<TSoftClassPtr<UStatusEffectBase>>& OutStatusEffects);
+
+	/**
+	 * Asynchronously loads a status effect class.
+	 * Requests for a class which is already loading are merged.
+	 *
+	 * @param StatusEffect The class to load
+	 * @param OnLoaded Called when loading finishes, even if it failed
+	 */
+	void RequestAsyncLoad(const TSoftClassPtr<UStatusEffectBase>& StatusEffect, const FStreamableDelegate& OnLoaded);
+
+	/**
+	 * Asynchronously loads status effect classes and keeps them loaded until the preload group is released.
+	 * Use it to load effects of an ability loadout or a map ahead of time and avoid hitches on the first apply.
+	 *
+	 * @param PreloadGroup The name of the group the classes are kept loaded by
+	 * @param StatusEffects The classes to load
+	 * @param OnPreloaded Called when all classes were loaded
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects", meta=(AutoCreateRefTerm="OnPreloaded"))
+	void PreloadStatusEffectClasses(const FName PreloadGroup,
+	                                const TArray<TSoftClassPtr<UStatusEffectBase>>& StatusEffects,
+	                                const FOnStatusEffectsPreloadedDynamicSignature& OnPreloaded);
+
+	/**
+	 * Lets classes of a preload group be unloaded
+	 *
+	 * @param PreloadGroup The name of the group to release
+	 */
+	UFUNCTION(BlueprintCallable, Category="StatusEffects")
+	void ReleasePreloadedStatusEffectClasses(const FName PreloadGroup);
+
+	/**
+	 * Checks if all classes of a preload group were loaded
+	 */
+	UFUNCTION(BlueprintPure, Category="StatusEffects")
+	bool IsPreloadGroupLoaded(const FName PreloadGroup) const;
+
+	/**
+	 * Checks if active status effects block a status effect class according to interaction rules of the project settings
+	 *
+	 * @param ClassId The ID of the class being applied
+	 * @param ActiveClassIds Bits of class IDs of active status effects
+	 */
+	bool IsBlockedByInteractionRules(const uint16 ClassId, const TBitArray<>& ActiveClassIds);
+
+	/**
+	 * Retrieves bits of class IDs cancelled by applying a status effect class according to interaction rules
+	 *
+	 * @return A pointer to the bits. nullptr if the class cancels nothing
+	 */
+	const TBitArray<>* GetCancelledClassIds(const uint16 ClassId);
+
+	/**
+	 * Makes interaction rules be compiled again on the next check
+	 */
+	void InvalidateInteractionRules() { bAreInteractionRulesCompiled = false; }
+
+	/**
+	 * Retrieves the hash of all registered class paths in ID order.
+	 * Processes with equal hashes resolve the same classes by the same IDs.
+	 */
+	uint32 GetRegistryHash();
+
+	/**
+	 * Checks if the registry hash of a remote process matches this one. Logs an error on the first mismatch
+	 *
+	 * @param RemoteHash The registry hash received from the server
+	 * @return true if class IDs of the remote process can be resolved locally
+	 */
+	bool VerifyRemoteRegistryHash(const uint32 RemoteHash);
+
+private:
+	FStreamableManager StreamableManager;
+
+	/**
+	 * Handles of preloaded classes by preload group
+	 */
+	TMap<FName, TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+	/**
+	 * Catalog entries indexed by class ID. Index 0 is reserved for InvalidClassId
+	 */
+	TArray<FStatusEffectCatalogEntry> Entries;
+
+	/**
+	 * Classes resolved by class ID
+	 */
+	TArray<TWeakObjectPtr<UClass>> ResolvedClasses;
+
+	TMap<FTopLevelAssetPath, uint16> ClassIds;
+
+	/**
+	 * Interaction rules compiled into rows indexed by class ID.
+	 * Empty rows mean the class isn't blocked by or doesn't cancel anything.
+	 */
+	TArray<TBitArray<>> BlockedByClassIds;
+
+	TArray<TBitArray<>> CancelledClassIds;
+
+	bool bIsBuilt = false;
+
+	bool bAreInteractionRulesCompiled = false;
+
+	uint32 RegistryHash = 0;
+
+	bool bHasReportedHashMismatch = false;
+
+	void EnsureBuilt();
+
+	void Build();
+
+	uint16 RegisterClassPath(const FTopLevelAssetPath& ClassPath);
+
+	void EnsureInteractionRulesCompiled();
+
+	void GetMatchingClassIds(const TSoftClassPtr<UStatusEffectBase>& StatusEffectClass,
+	                         const FGameplayTagContainer& EffectTags,
+	                         TArray<uint16>& OutClassIds) const;
+
+	static void GatherClassPaths(TArray<FTopLevelAssetPath>& OutClassPaths);
+
+	static bool IsTransientClassName(const FString& ClassName);
+
+	static bool IsSharedNativeClass(const UClass* StatusEffectClass);
+
+	static void FillEntryFromClass(FStatusEffectCatalogEntry& Entry, const UClass* StatusEffectClass);
+
+	static void FillEntryFromAssetData(FStatusEffectCatalogEntry& Entry, const FAssetData& AssetData);
+
+	static EStatusEffectEventOverrides CalculateEventOverrides(const UClass* StatusEffectClass);
+};
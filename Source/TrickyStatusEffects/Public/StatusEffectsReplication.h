@@ -0,0 +1,121 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "StatusEffectsReplication.generated.h"
+
+class AActor;
+class UStatusEffectBase;
+class UStatusEffectsManagerComponent;
+struct FReplicatedStatusEffectsList;
+
+/**
+ * Represents a replicated record of an active status effect
+ */
+USTRUCT()
+struct TRICKYSTATUSEFFECTS_API FReplicatedStatusEffect : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/**
+	 * The registry ID of the status effect class. Replicated instead of the class to save bandwidth
+	 */
+	UPROPERTY()
+	uint16 ClassId = 0;
+
+	/**
+	 * The actor which applied the status effect. Can be nullptr
+	 */
+	UPROPERTY()
+	TObjectPtr<AActor> Instigator = nullptr;
+
+	/**
+	 * The current number of stacks of the status effect
+	 */
+	UPROPERTY()
+	int32 CurrentStacks = 0;
+
+	/**
+	 * The server world time from which the elapsed time of the status effect is counted.
+	 * A negative value signifies an infinite status effect.
+	 */
+	UPROPERTY()
+	float StartTime = -1.f;
+
+	/**
+	 * The server world time at which the status effect ends.
+	 * A negative value signifies an infinite status effect.
+	 */
+	UPROPERTY()
+	float EndTime = -1.f;
+
+	/**
+	 * The local status effect instance. An active status effect on the server and its proxy on clients.
+	 */
+	TWeakObjectPtr<UStatusEffectBase> StatusEffect = nullptr;
+
+	void PreReplicatedRemove(const FReplicatedStatusEffectsList& InArraySerializer);
+
+	void PostReplicatedAdd(const FReplicatedStatusEffectsList& InArraySerializer);
+
+	void PostReplicatedChange(const FReplicatedStatusEffectsList& InArraySerializer);
+};
+
+/**
+ * Delta replicated list of active status effects
+ */
+USTRUCT()
+struct TRICKYSTATUSEFFECTS_API FReplicatedStatusEffectsList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FReplicatedStatusEffect> Items;
+
+	/**
+	 * The manager component which owns the list. Receives client side callbacks.
+	 */
+	UStatusEffectsManagerComponent* OwningManager = nullptr;
+
+	/**
+	 * Adds a record of a given status effect and marks it dirty
+	 */
+	void AddEntry(UStatusEffectBase* StatusEffect, AActor* Instigator);
+
+	/**
+	 * Updates the record of a given status effect.
+	 * The record is marked dirty only if stacks or timer stamps have changed.
+	 *
+	 * @return true if the record was found
+	 */
+	bool UpdateEntry(const UStatusEffectBase* StatusEffect);
+
+	/**
+	 * Removes the record of a given status effect
+	 *
+	 * @return true if the record was found
+	 */
+	bool RemoveEntry(const UStatusEffectBase* StatusEffect);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FastArrayDeltaSerialize<FReplicatedStatusEffect, FReplicatedStatusEffectsList>(Items,
+			DeltaParams,
+			*this);
+	}
+
+private:
+	int32 FindEntryIndex(const UStatusEffectBase* StatusEffect) const;
+};
+
+template <>
+struct TStructOpsTypeTraits<FReplicatedStatusEffectsList> : public TStructOpsTypeTraitsBase2<
+		FReplicatedStatusEffectsList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,67 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "GameplayTagContainer.h"
+#include "StatusEffectsSettings.generated.h"
+
+class UStatusEffectBase;
+
+UENUM(BlueprintType)
+enum class EStatusEffectInteraction : uint8
+{
+	// Active source status effects prevent target status effects from being applied
+	Block,
+	// Applying a source status effect removes active target status effects
+	Cancel
+};
+
+/**
+ * Declarative interaction between status effects, e.g. "Stun blocks Sleep" or "Cleanse cancels Debuff".
+ * Each side matches a status effect class or any status effect class which has any of the given tags.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYSTATUSEFFECTS_API FStatusEffectInteractionRule
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category="Source")
+	TSoftClassPtr<UStatusEffectBase> SourceClass = nullptr;
+
+	UPROPERTY(EditAnywhere, Category="Source")
+	FGameplayTagContainer SourceTags;
+
+	UPROPERTY(EditAnywhere, Category="Interaction")
+	EStatusEffectInteraction Interaction = EStatusEffectInteraction::Block;
+
+	UPROPERTY(EditAnywhere, Category="Target")
+	TSoftClassPtr<UStatusEffectBase> TargetClass = nullptr;
+
+	UPROPERTY(EditAnywhere, Category="Target")
+	FGameplayTagContainer TargetTags;
+};
+
+/**
+ * Project settings of the status effects system.
+ */
+UCLASS(Config=Game, DefaultConfig, meta=(DisplayName="Status Effects"))
+class TRICKYSTATUSEFFECTS_API UStatusEffectsSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectsSettings();
+
+	/**
+	 * Rules checked when a status effect is applied.
+	 * They're compiled into bit matrices indexed by registry class IDs, so checking them doesn't depend on rule count.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category="Interactions")
+	TArray<FStatusEffectInteractionRule> InteractionRules;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
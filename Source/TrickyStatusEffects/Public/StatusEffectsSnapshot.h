@@ -0,0 +1,71 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Saved state of a single status effect
+ */
+struct TRICKYSTATUSEFFECTS_API FStatusEffectSnapshotRecord
+{
+	/**
+	 * The path of the status effect class. Registry IDs aren't saved, as they can differ between builds
+	 */
+	FString ClassPath;
+
+	/**
+	 * The path of the actor which applied the status effect. Empty if there was no instigator
+	 */
+	FString InstigatorPath;
+
+	float RemainingTime = -1.f;
+
+	float TickPhase = -1.f;
+
+	int32 Stacks = 0;
+
+	/**
+	 * Remaining time of each stack from the oldest to the newest if stacks expire independently
+	 */
+	TArray<float> StackRemainingTimes;
+
+	/**
+	 * Custom data written by UStatusEffectBase::SerializeSnapshotPayload
+	 */
+	TArray<uint8> Payload;
+};
+
+/**
+ * Versioned binary snapshot of all status effects applied to a manager component.
+ * Encoding and decoding don't touch UObjects and can be done on any thread.
+ */
+struct TRICKYSTATUSEFFECTS_API FStatusEffectsSnapshot
+{
+	enum class EVersion : uint16
+	{
+		Initial = 1,
+
+		LatestPlusOne,
+		Latest = LatestPlusOne - 1
+	};
+
+	TArray<FStatusEffectSnapshotRecord> Records;
+
+	/**
+	 * Writes the snapshot into a compact binary blob
+	 */
+	void Encode(TArray<uint8>& OutData);
+
+	/**
+	 * Reads the snapshot from a binary blob
+	 *
+	 * @return true if the blob was successfully decoded
+	 */
+	bool Decode(const TArray<uint8>& Data);
+
+	bool Serialize(FArchive& Ar);
+
+private:
+	static constexpr uint32 Magic = 0x53534553;
+};
@@ -0,0 +1,38 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/**
+ * Stats of the status effects system. Use "stat StatusEffects" to display them.
+ */
+DECLARE_STATS_GROUP(TEXT("StatusEffects"), STATGROUP_StatusEffects, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply"), STAT_StatusEffects_Apply, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh"), STAT_StatusEffects_Refresh, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick"), STAT_StatusEffects_Tick, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Duration"), STAT_StatusEffects_Duration, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Deactivate"), STAT_StatusEffects_Deactivate, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Broadcast"), STAT_StatusEffects_Broadcast, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Replication"), STAT_StatusEffects_Replication, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Periodic"), STAT_StatusEffects_Periodic, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AttributeModifiers"), STAT_StatusEffects_AttributeModifiers, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Requests"), STAT_StatusEffects_Requests, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Managers"), STAT_StatusEffects_NumManagers, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Effects"), STAT_StatusEffects_NumActive, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Applied This Frame"), STAT_StatusEffects_NumApplied, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deactivated This Frame"), STAT_StatusEffects_NumDeactivated, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Ticks"), STAT_StatusEffects_NumDeferredTicks, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Queued Requests"), STAT_StatusEffects_NumRequests, STATGROUP_StatusEffects, TRICKYSTATUSEFFECTS_API);
+
+namespace StatusEffectsStats
+{
+	/**
+	 * Retrieves the stat ID used to measure ticks of a given status effect class.
+	 * IDs are created on the first call and cached by class name.
+	 */
+	TRICKYSTATUSEFFECTS_API TStatId GetClassStatId(const UClass* StatusEffectClass);
+}
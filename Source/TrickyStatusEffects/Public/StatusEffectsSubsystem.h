@@ -0,0 +1,223 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StatusEffectAttributeReceiver.h"
+#include "StatusEffectBase.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "Containers/Queue.h"
+#include "UObject/WeakInterfacePtr.h"
+#include "StatusEffectsSubsystem.generated.h"
+
+class IStatusEffectAttributeReceiver;
+class UPeriodicStatusEffect;
+class UStatusEffectsManagerComponent;
+
+/**
+ * The target of a queued status effect request, either an actor with a manager or the manager itself
+ */
+struct TRICKYSTATUSEFFECTS_API FStatusEffectRequestTarget
+{
+	FStatusEffectRequestTarget() = default;
+
+	FStatusEffectRequestTarget(AActor* InActor);
+
+	FStatusEffectRequestTarget(UStatusEffectsManagerComponent* InManager);
+
+	TWeakObjectPtr<AActor> Actor;
+
+	TWeakObjectPtr<UStatusEffectsManagerComponent> Manager;
+};
+
+/**
+ * Runs status effect ticks within a per-frame time budget set by StatusEffects.TickBudgetMs.
+ * Ticks which don't fit into the budget roll over to the next frame in round-robin order with accumulated delta time.
+ * Higher priority tiers are processed first, Critical status effects are never deferred.
+ * Duration timers aren't affected by the budget.
+ *
+ * Also processes periodic status effects of the world in a single native loop after actor ticks.
+ *
+ * Accepts apply, refresh and remove requests from any thread, e.g. hit detection or async traces on worker threads.
+ * Requests are kept in a lock-free queue and executed in a batch once per frame on the game thread.
+ * Cache the subsystem on the game thread before handing it to other threads.
+ */
+UCLASS()
+class TRICKYSTATUSEFFECTS_API UStatusEffectsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Checks if ticks of status effects are limited by the frame budget
+	 */
+	static bool IsTickBudgetEnabled();
+
+	/**
+	 * Queues a tick of a status effect to be processed within the budget.
+	 * A status effect is queued only once until its tick is processed.
+	 */
+	void QueueTick(UStatusEffectBase* StatusEffect);
+
+	/**
+	 * Retrieves the number of queued ticks of a given priority
+	 */
+	int32 GetNumQueuedTicks(const EStatusEffectTickPriority Priority) const;
+
+	/**
+	 * Starts changing the attribute of a periodic status effect
+	 *
+	 * @param StatusEffect The activated periodic status effect
+	 * @param Receiver The target receiving attribute changes
+	 */
+	void RegisterPeriodicStatusEffect(UPeriodicStatusEffect* StatusEffect, IStatusEffectAttributeReceiver* Receiver);
+
+	/**
+	 * Stops changing the attribute of a periodic status effect
+	 */
+	void UnregisterPeriodicStatusEffect(UPeriodicStatusEffect* StatusEffect);
+
+	/**
+	 * Retrieves the number of periodic status effects processed by the subsystem
+	 */
+	int32 GetNumPeriodicStatusEffects() const { return PeriodicKernels.Num() + PendingPeriodicKernels.Num(); }
+
+	/**
+	 * Retrieves the time left until the next attribute change of a periodic status effect
+	 *
+	 * @return The time in seconds. -1 if the status effect isn't registered
+	 */
+	float GetTimeToNextPeriod(const UPeriodicStatusEffect* StatusEffect) const;
+
+	/**
+	 * Queues applying a status effect. Thread-safe
+	 *
+	 * @param Target The actor or the manager to apply the status effect to
+	 * @param StatusEffect The class of the status effect to apply
+	 * @param Instigator The actor which applies the status effect. Can be nullptr
+	 */
+	void QueueApplyStatusEffect(const FStatusEffectRequestTarget& Target,
+	                            TSubclassOf<UStatusEffectBase> StatusEffect,
+	                            AActor* Instigator);
+
+	/**
+	 * Queues refreshing all status effects of a class. Thread-safe
+	 */
+	void QueueRefreshStatusEffect(const FStatusEffectRequestTarget& Target,
+	                              TSubclassOf<UStatusEffectBase> StatusEffect);
+
+	/**
+	 * Queues removing a status effect. Thread-safe
+	 *
+	 * @param Target The actor or the manager to remove the status effect from
+	 * @param StatusEffect The class of the status effect to remove
+	 * @param Remover The actor which removes the status effect. Can be nullptr
+	 */
+	void QueueRemoveStatusEffect(const FStatusEffectRequestTarget& Target,
+	                             TSubclassOf<UStatusEffectBase> StatusEffect,
+	                             AActor* Remover);
+
+	/**
+	 * Retrieves the number of requests waiting for the next batch
+	 */
+	int32 GetNumQueuedRequests() const { return NumQueuedRequests.load(std::memory_order_relaxed); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Queues of status effects waiting for their tick indexed by priority.
+	 * Status effects which weren't processed stay at the front of the queue.
+	 */
+	TArray<TWeakObjectPtr<UStatusEffectBase>> TickQueues[static_cast<uint8>(EStatusEffectTickPriority::Num)];
+
+	/**
+	 * Data needed to process a periodic status effect, kept in a flat array for the kernel loop
+	 */
+	struct FPeriodicKernel
+	{
+		UPeriodicStatusEffect* StatusEffect = nullptr;
+
+		/**
+		 * The target can be destroyed without deactivating its status effects, so it's held weakly
+		 */
+		TWeakInterfacePtr<IStatusEffectAttributeReceiver> Receiver;
+
+		FGameplayTag Attribute;
+
+		float Period = 1.f;
+
+		float TimeToNextPeriod = 1.f;
+	};
+
+	/**
+	 * Periodic status effects. Status effects unregistered during processing are removed after the loop
+	 */
+	TArray<FPeriodicKernel> PeriodicKernels;
+
+	/**
+	 * Periodic status effects registered during processing. Added after the loop, so processed kernels never move
+	 */
+	TArray<FPeriodicKernel> PendingPeriodicKernels;
+
+	/**
+	 * Kernel index of status effects waiting in PendingPeriodicKernels
+	 */
+	static constexpr int32 PendingKernelIndex = INDEX_NONE - 1;
+
+	bool bIsProcessingPeriodicKernels = false;
+
+	bool bHasUnregisteredPeriodicKernels = false;
+
+	enum class ERequestType : uint8
+	{
+		Apply,
+		Refresh,
+		Remove
+	};
+
+	struct FRequest
+	{
+		ERequestType Type = ERequestType::Apply;
+
+		FStatusEffectRequestTarget Target;
+
+		TSubclassOf<UStatusEffectBase> StatusEffect = nullptr;
+
+		TWeakObjectPtr<AActor> Instigator = nullptr;
+
+		/**
+		 * The ID of the queueing thread. Requests of the same producer keep their order within a batch
+		 */
+		uint32 ProducerId = 0;
+	};
+
+	/**
+	 * Requests queued by any thread. A drained batch is sorted by keys derived from the requests, not by their arrival
+	 */
+	TQueue<FRequest, EQueueMode::Mpsc> Requests;
+
+	std::atomic<int32> NumQueuedRequests = 0;
+
+	FDelegateHandle PostActorTickHandle;
+
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void QueueRequest(FRequest&& Request);
+
+	void ProcessRequests();
+
+	void ProcessTickQueues();
+
+	void ProcessPeriodicKernels(float DeltaTime);
+
+	void RemoveUnregisteredPeriodicKernels();
+
+	void AddPendingPeriodicKernels();
+};
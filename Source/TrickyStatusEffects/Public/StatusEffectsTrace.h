@@ -0,0 +1,72 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Config.h"
+
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+#define STATUSEFFECTS_TRACE_ENABLED 1
+#else
+#define STATUSEFFECTS_TRACE_ENABLED 0
+#endif
+
+#if STATUSEFFECTS_TRACE_ENABLED
+
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+class UStatusEffectBase;
+class AActor;
+
+/**
+ * Trace channel of the status effect lifecycle events.
+ * Enable it with -trace=StatusEffects or "Trace.Enable StatusEffects" to record events into Unreal Insights.
+ */
+UE_TRACE_CHANNEL_EXTERN(StatusEffectsChannel, TRICKYSTATUSEFFECTS_API)
+
+/**
+ * Emits status effect lifecycle events. Objects are identified by their unique IDs.
+ */
+struct TRICKYSTATUSEFFECTS_API FStatusEffectsTrace
+{
+	static void OutputActivated(const UStatusEffectBase* StatusEffect);
+
+	static void OutputRefreshed(const UStatusEffectBase* StatusEffect);
+
+	static void OutputStacksChanged(const UStatusEffectBase* StatusEffect, const int32 Delta);
+
+	static void OutputTicked(const UStatusEffectBase* StatusEffect, const float DeltaTime);
+
+	static void OutputDeactivated(const UStatusEffectBase* StatusEffect, const AActor* Deactivator);
+};
+
+#define TRACE_STATUSEFFECT_ACTIVATED(StatusEffect) \
+	FStatusEffectsTrace::OutputActivated(StatusEffect)
+
+#define TRACE_STATUSEFFECT_REFRESHED(StatusEffect) \
+	FStatusEffectsTrace::OutputRefreshed(StatusEffect)
+
+#define TRACE_STATUSEFFECT_STACKS_CHANGED(StatusEffect, Delta) \
+	FStatusEffectsTrace::OutputStacksChanged(StatusEffect, Delta)
+
+#define TRACE_STATUSEFFECT_TICKED(StatusEffect, DeltaTime) \
+	FStatusEffectsTrace::OutputTicked(StatusEffect, DeltaTime)
+
+#define TRACE_STATUSEFFECT_DEACTIVATED(StatusEffect, Deactivator) \
+	FStatusEffectsTrace::OutputDeactivated(StatusEffect, Deactivator)
+
+// Shows a named scope in the Insights timing view when the channel is enabled
+#define TRACE_STATUSEFFECTS_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, StatusEffectsChannel)
+
+#else
+
+#define TRACE_STATUSEFFECT_ACTIVATED(StatusEffect)
+#define TRACE_STATUSEFFECT_REFRESHED(StatusEffect)
+#define TRACE_STATUSEFFECT_STACKS_CHANGED(StatusEffect, Delta)
+#define TRACE_STATUSEFFECT_TICKED(StatusEffect, DeltaTime)
+#define TRACE_STATUSEFFECT_DEACTIVATED(StatusEffect, Deactivator)
+#define TRACE_STATUSEFFECTS_SCOPE(Name)
+
+#endif
@@ -26,6 +26,9 @@ public class TrickyStatusEffects : ModuleRules
 			new string[]
 			{
 				"Core",
+				"NetCore",
+				"GameplayTags",
+				"DeveloperSettings",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -36,6 +39,9 @@ public class TrickyStatusEffects : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"AssetRegistry",
+				"Projects",
+				"TraceLog",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
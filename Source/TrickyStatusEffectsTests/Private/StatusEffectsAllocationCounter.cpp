@@ -0,0 +1,181 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsAllocationCounter.h"
+
+#include "HAL/MemoryBase.h"
+#include "Misc/OutputDevice.h"
+#include <atomic>
+
+namespace StatusEffectsAllocationCounter
+{
+	/**
+	 * Forwards all calls to the engine allocator and counts allocations made by the counting thread
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		void BeginCounting()
+		{
+			NumAllocations = 0;
+			CountingThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+		}
+
+		uint64 EndCounting()
+		{
+			CountingThreadId.store(0, std::memory_order_relaxed);
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			InnerMalloc->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			InnerMalloc->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			InnerMalloc->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			InnerMalloc->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+
+	private:
+		FMalloc* InnerMalloc = nullptr;
+
+		std::atomic<uint32> CountingThreadId{0};
+
+		uint64 NumAllocations = 0;
+
+		void CountAllocation()
+		{
+			if (CountingThreadId.load(std::memory_order_relaxed) == FPlatformTLS::GetCurrentThreadId())
+			{
+				++NumAllocations;
+			}
+		}
+	};
+
+	static FCountingMalloc* CountingMalloc = nullptr;
+}
+
+void FStatusEffectsAllocationCounter::Install()
+{
+	using namespace StatusEffectsAllocationCounter;
+
+	// Installed once and never removed, as memory allocated through the wrapper can be freed at any time
+	if (!CountingMalloc)
+	{
+		CountingMalloc = new FCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+}
+
+bool FStatusEffectsAllocationCounter::IsInstalled()
+{
+	return StatusEffectsAllocationCounter::CountingMalloc != nullptr;
+}
+
+void FStatusEffectsAllocationCounter::BeginCounting()
+{
+	if (StatusEffectsAllocationCounter::CountingMalloc)
+	{
+		StatusEffectsAllocationCounter::CountingMalloc->BeginCounting();
+	}
+}
+
+uint64 FStatusEffectsAllocationCounter::EndCounting()
+{
+	return StatusEffectsAllocationCounter::CountingMalloc
+		       ? StatusEffectsAllocationCounter::CountingMalloc->EndCounting()
+		       : 0;
+}
@@ -0,0 +1,27 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Counts allocations made by the calling thread between BeginCounting and EndCounting.
+ * The module installs it on startup if the process runs with -StatusEffectsCountAllocs.
+ */
+class FStatusEffectsAllocationCounter
+{
+public:
+	/**
+	 * Wraps the engine allocator for the rest of the process lifetime. Does nothing if it's already installed
+	 */
+	static void Install();
+
+	static bool IsInstalled();
+
+	static void BeginCounting();
+
+	/**
+	 * @return The number of allocations since BeginCounting. 0 if the counter isn't installed
+	 */
+	static uint64 EndCounting();
+};
@@ -0,0 +1,389 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsBenchmark.h"
+
+#include "StatusEffectsAllocationCounter.h"
+#include "StatusEffectsManagerComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace StatusEffectsBenchmark
+{
+	static constexpr int32 EffectCounts[] = {1, 10, 100, 1000};
+
+	static int32 Iterations = 1000;
+
+	static FAutoConsoleVariableRef IterationsVariable(
+		TEXT("StatusEffects.Benchmark.Iterations"),
+		Iterations,
+		TEXT("The number of measured iterations of each TrickyStatusEffects.Benchmark automation test."));
+
+	struct FResult
+	{
+		FString Name;
+
+		int32 NumEffects = 0;
+
+		double NanosecondsPerOp = 0.0;
+
+		double AllocationsPerOp = 0.0;
+	};
+
+	/**
+	 * Runs benchmarks in a dedicated game world, so they don't depend on the world the tests are started from
+	 */
+	class FBenchmark
+	{
+	public:
+		explicit FBenchmark(FAutomationTestBase& InTest)
+			: Test(InTest)
+			, NumIterations(FMath::Max(Iterations, 1))
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("StatusEffectsBenchmark"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+			Instigator = SpawnActor();
+		}
+
+		~FBenchmark()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		/**
+		 * Runs a benchmark for each number of effects per manager and adds the results to the test report
+		 */
+		template <typename FRun>
+		bool Run(FRun&& RunBenchmark)
+		{
+			for (const int32 NumEffects : EffectCounts)
+			{
+				RunBenchmark(*this, NumEffects);
+			}
+
+			Test.AddInfo(FString::Printf(TEXT("%-40s %8s %12s %10s"),
+			                             TEXT("Benchmark"),
+			                             TEXT("Effects"),
+			                             TEXT("ns/op"),
+			                             TEXT("allocs/op")));
+
+			for (const FResult& Result : Results)
+			{
+				const FString Allocations = FStatusEffectsAllocationCounter::IsInstalled()
+					                            ? FString::Printf(TEXT("%.2f"), Result.AllocationsPerOp)
+					                            : FString(TEXT("n/a"));
+
+				Test.AddInfo(FString::Printf(TEXT("%-40s %8d %12.1f %10s"),
+				                             *Result.Name,
+				                             Result.NumEffects,
+				                             Result.NanosecondsPerOp,
+				                             *Allocations));
+			}
+
+			if (!FStatusEffectsAllocationCounter::IsInstalled())
+			{
+				Test.AddInfo(TEXT("Run with -StatusEffectsCountAllocs to count allocations per operation"));
+			}
+
+			return !Test.HasAnyErrors();
+		}
+
+		void RunApply(const int32 NumEffects)
+		{
+			const TPair<const TCHAR*, TSubclassOf<UStatusEffectBase>> Scopes[] = {
+				{TEXT("PerTarget"), UStatusEffectBenchmarkTimed::StaticClass()},
+				{TEXT("PerInstigator"), UStatusEffectBenchmarkPerInstigator::StaticClass()},
+				{TEXT("PerInstance"), UStatusEffectBenchmarkPerInstance::StaticClass()}
+			};
+
+			for (const TPair<const TCHAR*, TSubclassOf<UStatusEffectBase>>& Scope : Scopes)
+			{
+				UStatusEffectsManagerComponent* Manager = SpawnManager(
+					UStatusEffectBenchmarkPassive::StaticClass(), NumEffects);
+				UStatusEffectBase* StatusEffect = nullptr;
+				int32 NumFailed = 0;
+
+				Measure(FString::Printf(TEXT("Apply.Create.%s"), Scope.Key), NumEffects, NumIterations, 1,
+				        [] {},
+				        [&] { StatusEffect = Manager->ApplyStatusEffect(Scope.Value, Instigator); },
+				        [&]
+				        {
+					        if (!IsValid(StatusEffect))
+					        {
+						        ++NumFailed;
+						        return;
+					        }
+
+					        StatusEffect->Deactivate(nullptr);
+				        });
+
+				Test.TestEqual(FString::Printf(TEXT("Failed Apply.Create.%s"), Scope.Key), NumFailed, 0);
+
+				// Per instance status effects are never refreshed
+				if (Scope.Value == UStatusEffectBenchmarkPerInstance::StaticClass())
+				{
+					continue;
+				}
+
+				Manager = SpawnManager(UStatusEffectBenchmarkPassive::StaticClass(), NumEffects - 1);
+				Manager->ApplyStatusEffect(Scope.Value, Instigator);
+
+				Measure(FString::Printf(TEXT("Apply.Refresh.%s"), Scope.Key), NumEffects, NumIterations, 1,
+				        [] {},
+				        [&] { Manager->ApplyStatusEffect(Scope.Value, Instigator); },
+				        [] {});
+			}
+
+			UStatusEffectsManagerComponent* Manager = SpawnManager(
+				UStatusEffectBenchmarkPassive::StaticClass(), NumEffects - 1);
+			const TSubclassOf<UStatusEffectBase> Stacking = UStatusEffectBenchmarkStacking::StaticClass();
+			Manager->ApplyStatusEffect(Stacking, Instigator);
+
+			Measure(TEXT("Apply.Refresh.Stacking"), NumEffects, NumIterations, 1,
+			        [] {},
+			        [&] { Manager->ApplyStatusEffect(Stacking, Instigator); },
+			        [] {});
+		}
+
+		void RunQueries(const int32 NumEffects)
+		{
+			// The probe is applied last, so queries looking for it scan all status effects
+			UStatusEffectsManagerComponent* Manager = SpawnManager(
+				UStatusEffectBenchmarkPassive::StaticClass(), NumEffects - 1);
+			const TSubclassOf<UStatusEffectBase> Probe = UStatusEffectBenchmarkProbe::StaticClass();
+			const EStatusEffectType ProbeType = EStatusEffectType::Debuff;
+			Manager->ApplyStatusEffect(Probe, Instigator);
+
+			Test.TestTrue(TEXT("Probe is applied"), Manager->HasStatusEffect(Probe));
+
+			const TPair<const TCHAR*, TFunction<void()>> Queries[] = {
+				{TEXT("Query.HasStatusEffect"), [&] { Manager->HasStatusEffect(Probe); }},
+				{TEXT("Query.HasStatusEffectFromInstigator"), [&] { Manager->HasStatusEffectFromInstigator(Probe, Instigator); }},
+				{TEXT("Query.HasAnyStatusEffectFromInstigator"), [&] { Manager->HasAnyStatusEffectFromInstigator(Instigator); }},
+				{TEXT("Query.HasAnyStatusEffectOfType"), [&] { Manager->HasAnyStatusEffectOfType(ProbeType); }},
+				{TEXT("Query.GetStatusEffect"), [&] { Manager->GetStatusEffect(Probe); }},
+				{TEXT("Query.GetStatusEffectFromInstigator"), [&] { Manager->GetStatusEffectFromInstigator(Probe, Instigator); }},
+				{
+					TEXT("Query.GetAllStatusEffects"), [&]
+					{
+						TArray<UStatusEffectBase*> StatusEffects;
+						Manager->GetAllStatusEffects(StatusEffects);
+					}
+				},
+				{
+					TEXT("Query.GetAllStatusEffectsOfClass"), [&]
+					{
+						TArray<UStatusEffectBase*> StatusEffects;
+						Manager->GetAllStatusEffectsOfClass(StatusEffects, Probe);
+					}
+				},
+				{
+					TEXT("Query.GetAllStatusEffectsFromInstigator"), [&]
+					{
+						TArray<UStatusEffectBase*> StatusEffects;
+						Manager->GetAllStatusEffectsFromInstigator(StatusEffects, Instigator);
+					}
+				},
+				{
+					TEXT("Query.GetAllStatusEffectsOfType"), [&]
+					{
+						TArray<UStatusEffectBase*> StatusEffects;
+						Manager->GetAllStatusEffectsOfType(StatusEffects, ProbeType);
+					}
+				}
+			};
+
+			for (const TPair<const TCHAR*, TFunction<void()>>& Query : Queries)
+			{
+				Measure(Query.Key, NumEffects, NumIterations, 1, [] {}, Query.Value, [] {});
+			}
+		}
+
+		void RunRemoval(const int32 NumEffects)
+		{
+			// Refilling dominates the run time, so the number of iterations is scaled down with the number of effects
+			const int32 NumRemovalIterations = FMath::Max(NumIterations / NumEffects, 10);
+			const TSubclassOf<UStatusEffectBase> Filler = UStatusEffectBenchmarkPassive::StaticClass();
+			UStatusEffectsManagerComponent* Manager = SpawnManager(Filler, 0);
+
+			// Each measurement must remove everything on its own, or the next one would clean up after it
+			auto TestRemovedAll = [this, Manager](const TCHAR* Name)
+			{
+				TArray<UStatusEffectBase*> StatusEffects;
+				Manager->GetAllStatusEffects(StatusEffects);
+				Test.TestEqual(FString::Printf(TEXT("Status effects left after %s"), Name), StatusEffects.Num(), 0);
+			};
+
+			Measure(TEXT("Remove.All"), NumEffects, NumRemovalIterations, NumEffects,
+			        [&] { Fill(Manager, Filler, NumEffects); },
+			        [&] { Manager->RemoveAllStatusEffects(nullptr); },
+			        [] {});
+			TestRemovedAll(TEXT("Remove.All"));
+
+			Measure(TEXT("Remove.AllOfClass"), NumEffects, NumRemovalIterations, NumEffects,
+			        [&] { Fill(Manager, Filler, NumEffects); },
+			        [&] { Manager->RemoveAllStatusEffectsOfClass(Filler, nullptr); },
+			        [] {});
+			TestRemovedAll(TEXT("Remove.AllOfClass"));
+		}
+
+		void RunTick(const TCHAR* Name, const TSubclassOf<UStatusEffectBase>& StatusEffectClass, const int32 NumEffects)
+		{
+			UStatusEffectsManagerComponent* Manager = SpawnManager(StatusEffectClass, NumEffects);
+			TArray<UStatusEffectBase*> StatusEffects;
+			Manager->GetAllStatusEffects(StatusEffects);
+			constexpr float DeltaTime = 0.001f;
+
+			// Status effects tick once per frame, so the frame counter is advanced for each iteration.
+			// It's never moved back, as other tickables would skip frames they have already seen
+			Measure(Name, NumEffects, FMath::Max(NumIterations / NumEffects, 10), NumEffects,
+			        [] { ++GFrameCounter; },
+			        [&]
+			        {
+				        for (FTickableGameObject* StatusEffect : StatusEffects)
+				        {
+					        StatusEffect->Tick(DeltaTime);
+				        }
+			        },
+			        [] {});
+		}
+
+	private:
+		FAutomationTestBase& Test;
+
+		int32 NumIterations = 0;
+
+		UWorld* World = nullptr;
+
+		AActor* Instigator = nullptr;
+
+		TArray<FResult> Results;
+
+		AActor* SpawnActor() const
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.ObjectFlags |= RF_Transient;
+			return World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		}
+
+		UStatusEffectsManagerComponent* SpawnManager(const TSubclassOf<UStatusEffectBase> Filler, const int32 NumFillers) const
+		{
+			AActor* Target = SpawnActor();
+			UStatusEffectsManagerComponent* Manager = NewObject<UStatusEffectsManagerComponent>(Target);
+			Manager->SetIsReplicated(false);
+			Manager->RegisterComponent();
+			Fill(Manager, Filler, NumFillers);
+			return Manager;
+		}
+
+		static void Fill(UStatusEffectsManagerComponent* Manager,
+		                 const TSubclassOf<UStatusEffectBase> Filler,
+		                 const int32 NumFillers)
+		{
+			for (int32 Index = 0; Index < NumFillers; ++Index)
+			{
+				Manager->ApplyStatusEffect(Filler, nullptr);
+			}
+		}
+
+		/**
+		 * Measures Op only. Setup and Teardown run before and after each measured iteration
+		 */
+		template <typename FSetup, typename FOp, typename FTeardown>
+		void Measure(const FString& Name,
+		             const int32 NumEffects,
+		             const int32 NumMeasuredIterations,
+		             const int32 OpsPerIteration,
+		             FSetup&& Setup,
+		             FOp&& Op,
+		             FTeardown&& Teardown)
+		{
+			uint64 NumCycles = 0;
+			uint64 NumAllocations = 0;
+
+			for (int32 Iteration = 0; Iteration < NumMeasuredIterations; ++Iteration)
+			{
+				Setup();
+
+				FStatusEffectsAllocationCounter::BeginCounting();
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+				Op();
+				NumCycles += FPlatformTime::Cycles64() - StartCycles;
+				NumAllocations += FStatusEffectsAllocationCounter::EndCounting();
+
+				Teardown();
+			}
+
+			const double NumOps = static_cast<double>(NumMeasuredIterations) * OpsPerIteration;
+			FResult& Result = Results.AddDefaulted_GetRef();
+			Result.Name = Name;
+			Result.NumEffects = NumEffects;
+			Result.NanosecondsPerOp = FPlatformTime::ToSeconds64(NumCycles) * 1e9 / NumOps;
+			Result.AllocationsPerOp = NumAllocations / NumOps;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStatusEffectsBenchmarkApplyTest,
+                                 "TrickyStatusEffects.Benchmark.Apply",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FStatusEffectsBenchmarkApplyTest::RunTest(const FString& Parameters)
+{
+	StatusEffectsBenchmark::FBenchmark Benchmark(*this);
+	return Benchmark.Run([](StatusEffectsBenchmark::FBenchmark& Runner, const int32 NumEffects)
+	{
+		Runner.RunApply(NumEffects);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStatusEffectsBenchmarkQueryTest,
+                                 "TrickyStatusEffects.Benchmark.Query",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FStatusEffectsBenchmarkQueryTest::RunTest(const FString& Parameters)
+{
+	StatusEffectsBenchmark::FBenchmark Benchmark(*this);
+	return Benchmark.Run([](StatusEffectsBenchmark::FBenchmark& Runner, const int32 NumEffects)
+	{
+		Runner.RunQueries(NumEffects);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStatusEffectsBenchmarkRemoveTest,
+                                 "TrickyStatusEffects.Benchmark.Remove",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FStatusEffectsBenchmarkRemoveTest::RunTest(const FString& Parameters)
+{
+	StatusEffectsBenchmark::FBenchmark Benchmark(*this);
+	return Benchmark.Run([](StatusEffectsBenchmark::FBenchmark& Runner, const int32 NumEffects)
+	{
+		Runner.RunRemoval(NumEffects);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStatusEffectsBenchmarkTickTest,
+                                 "TrickyStatusEffects.Benchmark.Tick",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FStatusEffectsBenchmarkTickTest::RunTest(const FString& Parameters)
+{
+	StatusEffectsBenchmark::FBenchmark Benchmark(*this);
+	return Benchmark.Run([](StatusEffectsBenchmark::FBenchmark& Runner, const int32 NumEffects)
+	{
+		Runner.RunTick(TEXT("Tick"), UStatusEffectBenchmarkTicking::StaticClass(), NumEffects);
+		Runner.RunTick(TEXT("Tick.Native"), UStatusEffectBenchmarkNativeTicking::StaticClass(), NumEffects);
+	});
+}
+
+#endif
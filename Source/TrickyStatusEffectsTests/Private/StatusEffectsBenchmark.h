@@ -0,0 +1,167 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NativeStatusEffect.h"
+#include "StatusEffectBase.h"
+#include "StatusEffectsBenchmark.generated.h"
+
+namespace StatusEffectsBenchmark
+{
+	/**
+	 * Sets a config property of a benchmark status effect in its constructor.
+	 * Config properties of UStatusEffectBase are private, so they're set through reflection like in the editor.
+	 */
+	template <typename T>
+	void SetConfig(UStatusEffectBase* StatusEffect, const TCHAR* PropertyName, const T& Value)
+	{
+		const FProperty* Property = FindFProperty<FProperty>(UStatusEffectBase::StaticClass(), PropertyName);
+		check(Property && Property->GetElementSize() == sizeof(T));
+		Property->SetValue_InContainer(StatusEffect, &Value);
+	}
+}
+
+/**
+ * Infinite status effect without tick. Applied once per instance
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkPassive : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkPassive()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerInstance);
+	}
+};
+
+/**
+ * Status effect with a finite duration and no tick
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkTimed : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkTimed()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerTarget);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("bIsInfinite"), false);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("Duration"), 5.f);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("TimerBehavior"), EStatusEffectTimerRefreshBehavior::Reset);
+	}
+};
+
+/**
+ * Status effect ticking every frame
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkTicking : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkTicking()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerInstance);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("bTickEffect"), true);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("bIsInfinite"), false);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("Duration"), 10.f);
+	}
+};
+
+/**
+ * Status effect ticking every frame with statically dispatched handlers. Compared against the Blueprint dispatch
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkNativeTicking : public UStatusEffectBase,
+                                            public TStatusEffect<UStatusEffectBenchmarkNativeTicking>
+{
+	GENERATED_BODY()
+
+public:
+	struct FConfig : FStatusEffectNativeConfig
+	{
+		static constexpr bool bTickEffect = true;
+		static constexpr bool bIsInfinite = false;
+		static constexpr float Duration = 10.f;
+	};
+
+	UStatusEffectBenchmarkNativeTicking()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerInstance);
+	}
+
+	void NativeTickEffect(float DeltaTime)
+	{
+	}
+};
+
+/**
+ * Stackable status effect gaining a stack on each refresh
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkStacking : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkStacking()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerTarget);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("bIsInfinite"), false);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("Duration"), 5.f);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("TimerBehavior"), EStatusEffectTimerRefreshBehavior::Reset);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("bIsStackable"), true);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("MaxStacks"), 10);
+		StatusEffectsBenchmark::SetConfig(this, TEXT("StacksBehavior"), EStatusEffectStacksRefreshBehavior::Increase);
+	}
+};
+
+/**
+ * Timed status effect applied per instigator
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkPerInstigator : public UStatusEffectBenchmarkTimed
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkPerInstigator()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerInstigator);
+	}
+};
+
+/**
+ * Timed status effect applied per instance
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkPerInstance : public UStatusEffectBenchmarkTimed
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkPerInstance()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectScope"), EStatusEffectScope::PerInstance);
+	}
+};
+
+/**
+ * Debuff searched for by query benchmarks. Applied after filler status effects to make queries scan them all
+ */
+UCLASS(NotBlueprintable, HideDropdown)
+class UStatusEffectBenchmarkProbe : public UStatusEffectBase
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectBenchmarkProbe()
+	{
+		StatusEffectsBenchmark::SetConfig(this, TEXT("EffectType"), EStatusEffectType::Debuff);
+	}
+};
@@ -0,0 +1,274 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "StatusEffectsSoakCommandlet.h"
+
+#include "StatusEffectsBenchmark.h"
+#include "StatusEffectsManagerComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace StatusEffectsSoak
+{
+	struct FArchetype
+	{
+		TSubclassOf<UStatusEffectBase> StatusEffectClass;
+
+		float Weight = 1.f;
+	};
+
+	static void ParseMix(const FString& Mix, TArray<FArchetype>& OutArchetypes)
+	{
+		const TMap<FString, TSubclassOf<UStatusEffectBase>> Classes = {
+			{TEXT("Ticking"), UStatusEffectBenchmarkTicking::StaticClass()},
+			{TEXT("Timed"), UStatusEffectBenchmarkTimed::StaticClass()},
+			{TEXT("Stacking"), UStatusEffectBenchmarkStacking::StaticClass()},
+			{TEXT("Passive"), UStatusEffectBenchmarkPassive::StaticClass()}
+		};
+
+		TArray<FString> Entries;
+		Mix.ParseIntoArray(Entries, TEXT(","));
+
+		for (const FString& Entry : Entries)
+		{
+			FString Name, Weight;
+
+			if (!Entry.Split(TEXT(":"), &Name, &Weight))
+			{
+				Name = Entry;
+				Weight = TEXT("1");
+			}
+
+			const TSubclassOf<UStatusEffectBase>* StatusEffectClass = Classes.Find(Name.TrimStartAndEnd());
+
+			if (!StatusEffectClass)
+			{
+				UE_LOG(LogStatusEffect, Warning, TEXT("Unknown soak test archetype: %s"), *Name);
+				continue;
+			}
+
+			OutArchetypes.Add({*StatusEffectClass, FMath::Max(FCString::Atof(*Weight), 0.f)});
+		}
+	}
+
+	static double GetPercentile(TArray<double>& Values, const double Percentile)
+	{
+		if (Values.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+}
+
+UStatusEffectsSoakCommandlet::UStatusEffectsSoakCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UStatusEffectsSoakCommandlet::Main(const FString& Params)
+{
+	int32 NumActors = 1000;
+	float Minutes = 5.f;
+	float Rate = 1000.f;
+	float TickRate = 30.f;
+	float GCInterval = 60.f;
+	int32 Seed = 0;
+	FString Mix = TEXT("Ticking:1,Timed:1,Stacking:1,Passive:1");
+	FString OutputPath = FPaths::ProfilingDir() / TEXT("StatusEffects")
+		/ FString::Printf(TEXT("Soak-%s.csv"), *FDateTime::Now().ToString());
+
+	FParse::Value(*Params, TEXT("Actors="), NumActors);
+	FParse::Value(*Params, TEXT("Minutes="), Minutes);
+	FParse::Value(*Params, TEXT("Rate="), Rate);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("GCInterval="), GCInterval);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Mix="), Mix, false);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<StatusEffectsSoak::FArchetype> Archetypes;
+	StatusEffectsSoak::ParseMix(Mix, Archetypes);
+
+	float TotalWeight = 0.f;
+
+	for (const StatusEffectsSoak::FArchetype& Archetype : Archetypes)
+	{
+		TotalWeight += Archetype.Weight;
+	}
+
+	if (NumActors <= 0 || TickRate <= 0.f || TotalWeight <= 0.f)
+	{
+		UE_LOG(LogStatusEffect, Error, TEXT("Invalid soak test parameters: %s"), *Params);
+		return 1;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("StatusEffectsSoak"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	TArray<AActor*> Actors;
+	TArray<UStatusEffectsManagerComponent*> Managers;
+	Actors.Reserve(NumActors);
+	Managers.Reserve(NumActors);
+
+	for (int32 Index = 0; Index < NumActors; ++Index)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UStatusEffectsManagerComponent* Manager = NewObject<UStatusEffectsManagerComponent>(Actor);
+		Manager->SetIsReplicated(false);
+		Manager->RegisterComponent();
+		Actors.Add(Actor);
+		Managers.Add(Manager);
+	}
+
+	FString Csv = TEXT("Time,FrameMsP50,FrameMsP90,FrameMsP99,FrameMsMax,GCMs,UsedMemoryMB,PeakMemoryMB,ActiveEffects,Applies\n");
+	TArray<double> AllFrameTimes;
+	TArray<double> WindowFrameTimes;
+	FRandomStream Random(Seed);
+	const float DeltaTime = 1.f / TickRate;
+	const int32 NumFrames = FMath::CeilToInt(Minutes * 60.f * TickRate);
+	float PendingApplies = 0.f;
+	float TimeSinceGC = 0.f;
+	double WindowGCTime = 0.0;
+	double TotalGCTime = 0.0;
+	int32 WindowApplies = 0;
+	int32 MaxActiveEffects = 0;
+
+	UE_LOG(LogStatusEffect, Display, TEXT("Status effects soak test started. Actors: %d | Minutes: %.1f | Rate: %.0f/s"),
+	       NumActors,
+	       Minutes,
+	       Rate);
+
+	for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+	{
+		const double FrameStartTime = FPlatformTime::Seconds();
+
+		PendingApplies += Rate * DeltaTime;
+
+		for (; PendingApplies >= 1.f; PendingApplies -= 1.f)
+		{
+			UStatusEffectsManagerComponent* Manager = Managers[Random.RandHelper(NumActors)];
+			AActor* Instigator = Actors[Random.RandHelper(NumActors)];
+			float Roll = Random.FRand() * TotalWeight;
+
+			for (const StatusEffectsSoak::FArchetype& Archetype : Archetypes)
+			{
+				Roll -= Archetype.Weight;
+
+				if (Roll > 0.f)
+				{
+					continue;
+				}
+
+				// Passive status effects never expire, so they're toggled to keep their number bounded
+				if (Archetype.StatusEffectClass == UStatusEffectBenchmarkPassive::StaticClass()
+					&& Manager->HasStatusEffect(Archetype.StatusEffectClass))
+				{
+					Manager->RemoveStatusEffect(Archetype.StatusEffectClass, Instigator);
+				}
+				else
+				{
+					Manager->ApplyStatusEffect(Archetype.StatusEffectClass, Instigator);
+				}
+
+				++WindowApplies;
+				break;
+			}
+		}
+
+		// There is no engine loop in commandlets, so the frame counter and tickables are advanced manually
+		++GFrameCounter;
+		World->Tick(LEVELTICK_All, DeltaTime);
+		FTickableGameObject::TickObjects(World, LEVELTICK_All, false, DeltaTime);
+
+		const double FrameTime = (FPlatformTime::Seconds() - FrameStartTime) * 1000.0;
+		AllFrameTimes.Add(FrameTime);
+		WindowFrameTimes.Add(FrameTime);
+
+		TimeSinceGC += DeltaTime;
+
+		if (GCInterval > 0.f && TimeSinceGC >= GCInterval)
+		{
+			const double GCStartTime = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const double GCTime = (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+			WindowGCTime += GCTime;
+			TotalGCTime += GCTime;
+			TimeSinceGC = 0.f;
+		}
+
+		// Samples are written once per simulated second
+		if (Frame % FMath::Max(FMath::RoundToInt(TickRate), 1) != 0 && Frame != NumFrames)
+		{
+			continue;
+		}
+
+		int32 NumActiveEffects = 0;
+		TArray<UStatusEffectBase*> StatusEffects;
+
+		for (const UStatusEffectsManagerComponent* Manager : Managers)
+		{
+			StatusEffects.Reset();
+			Manager->GetAllStatusEffects(StatusEffects);
+			NumActiveEffects += StatusEffects.Num();
+		}
+
+		MaxActiveEffects = FMath::Max(MaxActiveEffects, NumActiveEffects);
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		const double FrameTimeMax = FMath::Max(WindowFrameTimes);
+
+		Csv += FString::Printf(TEXT("%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%d,%d\n"),
+		                       Frame * DeltaTime,
+		                       StatusEffectsSoak::GetPercentile(WindowFrameTimes, 0.5),
+		                       StatusEffectsSoak::GetPercentile(WindowFrameTimes, 0.9),
+		                       StatusEffectsSoak::GetPercentile(WindowFrameTimes, 0.99),
+		                       FrameTimeMax,
+		                       WindowGCTime,
+		                       MemoryStats.UsedPhysical / (1024.0 * 1024.0),
+		                       MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0),
+		                       NumActiveEffects,
+		                       WindowApplies);
+
+		WindowFrameTimes.Reset();
+		WindowGCTime = 0.0;
+		WindowApplies = 0;
+	}
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	UE_LOG(LogStatusEffect, Display,
+	       TEXT("Status effects soak test finished. Frame ms P50: %.3f | P90: %.3f | P99: %.3f | GC ms: %.1f | ")
+	       TEXT("Peak memory MB: %.1f | Max active effects: %d"),
+	       StatusEffectsSoak::GetPercentile(AllFrameTimes, 0.5),
+	       StatusEffectsSoak::GetPercentile(AllFrameTimes, 0.9),
+	       StatusEffectsSoak::GetPercentile(AllFrameTimes, 0.99),
+	       TotalGCTime,
+	       MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0),
+	       MaxActiveEffects);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogStatusEffect, Error, TEXT("Failed to write soak test results to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogStatusEffect, Display, TEXT("Soak test results written to %s"), *OutputPath);
+	return 0;
+}
@@ -0,0 +1,27 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "StatusEffectsSoakCommandlet.generated.h"
+
+/**
+ * Simulates actors with status effects in a headless game world and writes performance samples as CSV.
+ *
+ * Usage: -run=StatusEffectsSoak [Actors=1000] [Minutes=5] [Rate=1000] [TickRate=30] [GCInterval=60] [Seed=0]
+ *        [Mix=Ticking:1,Timed:1,Stacking:1,Passive:1] [Output=FilePath]
+ *
+ * Rate is the number of applies per second. Time is simulated with a fixed step of 1 / TickRate,
+ * so the run takes as long as the hardware needs to process it.
+ */
+UCLASS()
+class UStatusEffectsSoakCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UStatusEffectsSoakCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,19 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyStatusEffectsTests.h"
+
+#include "StatusEffectsAllocationCounter.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+void FTrickyStatusEffectsTestsModule::StartupModule()
+{
+	// The counting allocator stays for the lifetime of the process, so it's opt-in
+	if (FParse::Param(FCommandLine::Get(), TEXT("StatusEffectsCountAllocs")))
+	{
+		FStatusEffectsAllocationCounter::Install();
+	}
+}
+
+IMPLEMENT_MODULE(FTrickyStatusEffectsTestsModule, TrickyStatusEffectsTests)
@@ -0,0 +1,11 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "Modules/ModuleManager.h"
+
+class FTrickyStatusEffectsTestsModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+};
@@ -0,0 +1,27 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+using UnrealBuildTool;
+
+public class TrickyStatusEffectsTests : ModuleRules
+{
+	public TrickyStatusEffectsTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"TrickyStatusEffects",
+			}
+			);
+	}
+}